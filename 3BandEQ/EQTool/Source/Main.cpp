@@ -0,0 +1,847 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 18 Oct 2026
+
+    Command line companion of the 3BandEQ plugin for offline work on files.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/FilterChain.h"
+#include "../../Source/ParallelRenderer.h"
+#include "../../Source/SpectrumMatcher.h"
+#include "../../Source/DspKernels.h"
+#include "../../Source/EQEngine.h"
+#include "../../Source/ParallelCutFilter.h"
+#include "../../Source/PluginProcessor.h"
+
+//==============================================================================
+//chain settings from the command line, everything not given keeps the plugin's default
+static ChainSettings parseChainSettings(const juce::ArgumentList& args)
+{
+    ChainSettings settings;
+    settings.lowCutFreq = 20.f;
+    settings.highCutFreq = 20000.f;
+    settings.peakFreq = 750.f;
+    settings.peakGainInDecibels = 0.f;
+    settings.peakQuality = 1.f;
+
+    auto getFloat = [&args](const juce::String& option, float& value)
+    {
+        if( args.containsOption(option) )
+            value = args.getValueForOption(option).getFloatValue();
+    };
+    //slopes are given in dB/Oct (12, 24, 36 or 48)
+    auto getSlope = [&args](const juce::String& option, Slope& slope)
+    {
+        if( args.containsOption(option) )
+            slope = static_cast<Slope>(juce::jlimit(0, 3, args.getValueForOption(option).getIntValue() / 12 - 1));
+    };
+
+    getFloat("--lowcut", settings.lowCutFreq);
+    getFloat("--highcut", settings.highCutFreq);
+    getFloat("--peak", settings.peakFreq);
+    getFloat("--gain", settings.peakGainInDecibels);
+    getFloat("--q", settings.peakQuality);
+    getSlope("--lowcut-slope", settings.lowCutSlope);
+    getSlope("--highcut-slope", settings.highCutSlope);
+
+    return settings;
+}
+
+static int getNumThreads(const juce::ArgumentList& args)
+{
+    if( args.containsOption("--threads") )
+        return juce::jmax(1, args.getValueForOption("--threads").getIntValue());
+
+    return juce::SystemStats::getNumCpus();
+}
+
+//==============================================================================
+//filter one (possibly very long) file on all cores
+static void renderFile(const juce::ArgumentList& args)
+{
+    args.checkMinNumArguments(3);
+    auto inputFile = args[1].resolveAsExistingFile();
+    auto outputFile = args[2].resolveAsFile();
+    auto settings = parseChainSettings(args);
+    const int numThreads = getNumThreads(args);
+    const bool verify = args.containsOption("--verify");
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(inputFile));
+    if( reader == nullptr )
+        juce::ConsoleApplication::fail("Can't read " + inputFile.getFullPathName());
+
+    const int numChannels = int(reader->numChannels);
+
+    outputFile.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream(outputFile.createOutputStream());
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    if( stream != nullptr )
+        writer.reset(juce::WavAudioFormat().createWriterFor(stream.get(), reader->sampleRate, juce::uint32(numChannels),
+                                                            24, {}, 0));
+    if( writer == nullptr )
+        juce::ConsoleApplication::fail("Can't write " + outputFile.getFullPathName());
+    //the writer owns the stream now
+    stream.release();
+
+    juce::ThreadPool pool(numThreads);
+    ParallelRenderer renderer(settings, reader->sampleRate, numChannels, pool);
+    //the sequential reference renders the same stream to compare output and time against
+    std::unique_ptr<ParallelRenderer> reference;
+    if( verify )
+        reference = std::make_unique<ParallelRenderer>(settings, reader->sampleRate, numChannels, pool, 1);
+
+    //chunks are long enough that every thread gets segments much longer than the warm-up
+    const int chunkLength = juce::jmax(1 << 20, numThreads * 16 * renderer.getWarmUpLength());
+    juce::AudioBuffer<float> input(numChannels, chunkLength), output(numChannels, chunkLength), referenceOutput;
+    if( verify )
+        referenceOutput.setSize(numChannels, chunkLength);
+
+    std::cout << "warm-up: " << renderer.getWarmUpLength() << " samples, "
+              << numThreads << " threads" << std::endl;
+
+    double parallelSeconds = 0.0, sequentialSeconds = 0.0;
+    float maxError = 0.f;
+
+    for( juce::int64 position = 0; position < reader->lengthInSamples; position += chunkLength )
+    {
+        const int num = int(juce::jmin(juce::int64(chunkLength), reader->lengthInSamples - position));
+        input.setSize(numChannels, num, false, false, true);
+        output.setSize(numChannels, num, false, false, true);
+        reader->read(&input, 0, num, position, true, true);
+
+        auto start = juce::Time::getMillisecondCounterHiRes();
+        renderer.process(input, output);
+        parallelSeconds += (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+
+        if( verify )
+        {
+            referenceOutput.setSize(numChannels, num, false, false, true);
+            start = juce::Time::getMillisecondCounterHiRes();
+            reference->processSequential(input, referenceOutput);
+            sequentialSeconds += (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+
+            for( int ch = 0; ch < numChannels; ++ch )
+                for( int i = 0; i < num; ++i )
+                    maxError = juce::jmax(maxError, std::abs(output.getSample(ch, i) - referenceOutput.getSample(ch, i)));
+        }
+
+        writer->writeFromAudioSampleBuffer(output, 0, num);
+    }
+
+    const double audioSeconds = double(reader->lengthInSamples) / reader->sampleRate;
+    std::cout << "rendered " << audioSeconds << " s of audio in " << parallelSeconds << " s ("
+              << audioSeconds / juce::jmax(1.0e-9, parallelSeconds) << "x realtime)" << std::endl;
+
+    if( verify )
+        std::cout << "sequential: " << sequentialSeconds << " s, speedup "
+                  << sequentialSeconds / juce::jmax(1.0e-9, parallelSeconds) << "x, max difference "
+                  << juce::Decibels::gainToDecibels(maxError, -200.f) << " dB" << std::endl;
+}
+
+//==============================================================================
+//fit the chain settings that make a source sound like a reference
+static void matchFiles(const juce::ArgumentList& args)
+{
+    args.checkMinNumArguments(3);
+    auto sourceFile = args[1].resolveAsExistingFile();
+    auto referenceFile = args[2].resolveAsExistingFile();
+    const int numThreads = getNumThreads(args);
+
+    juce::ThreadPool pool(numThreads);
+    AverageSpectrum source, reference;
+
+    auto analyze = [&pool](const juce::File& file, AverageSpectrum& spectrum)
+    {
+        auto result = SpectrumMatcher::analyzeFile(file, pool, spectrum);
+        if( result.failed() )
+            juce::ConsoleApplication::fail(result.getErrorMessage());
+    };
+
+    auto start = juce::Time::getMillisecondCounterHiRes();
+    analyze(sourceFile, source);
+    analyze(referenceFile, reference);
+    const auto analysisSeconds = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+
+    //the filters are designed for the source's rate unless the plugin will run at another one
+    const double sampleRate = args.containsOption("--rate") ? args.getValueForOption("--rate").getDoubleValue()
+                                                            : source.sampleRate;
+
+    start = juce::Time::getMillisecondCounterHiRes();
+    const auto match = SpectrumMatcher::fit(source, reference, sampleRate);
+    const auto fitSeconds = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+
+    const auto& settings = match.settings;
+    std::cout << "analyzed " << source.numFrames + reference.numFrames << " frames in " << analysisSeconds
+              << " s on " << numThreads << " threads, fitted in " << fitSeconds << " s" << std::endl
+              << "--lowcut=" << settings.lowCutFreq << " --lowcut-slope=" << 12 * (settings.lowCutSlope + 1)
+              << " --peak=" << settings.peakFreq << " --gain=" << settings.peakGainInDecibels
+              << " --q=" << settings.peakQuality
+              << " --highcut=" << settings.highCutFreq << " --highcut-slope=" << 12 * (settings.highCutSlope + 1) << std::endl
+              << "level offset: " << match.levelOffsetInDecibels << " dB, remaining difference: "
+              << match.remainingErrorInDecibels << " dB rms" << std::endl;
+}
+
+//==============================================================================
+//compare the parallel sections with the cascade where they're hardest to get right:
+//the stopband of steep cuts far below (above) the cut frequency, and DC through the low cuts
+static void checkParallelCutFilters(const juce::ArgumentList&)
+{
+    struct Case
+    {
+        bool lowCut;
+        float cutFreq;
+        Slope slope;
+        double sampleRate, testFreq;
+    };
+
+    std::vector<Case> cases;
+    for( double sampleRate : { 44100.0, 48000.0, 96000.0, 192000.0 } )
+    {
+        for( int s = Slope_12; s <= Slope_48; ++s )
+        {
+            const auto slope = static_cast<Slope>(s);
+            for( float cutFreq : { 20.f, 40.f } )
+            {
+                cases.push_back({ true, cutFreq, slope, sampleRate, cutFreq / 4.0 });
+                cases.push_back({ true, cutFreq, slope, sampleRate, 0.0 });
+            }
+            cases.push_back({ false, 200.f, slope, sampleRate, 2000.0 });
+            cases.push_back({ false, 15000.f, slope, sampleRate, 0.48 * sampleRate });
+        }
+    }
+
+    //steady state amplitude of the response to a unit sine (a constant 1 for DC), after 8 s of settling
+    auto measure = [](auto&& process, double sampleRate, double freq)
+    {
+        const int settling = int(8.0 * sampleRate);
+        //a whole number of periods, at least one second
+        const int length = freq > 0.0 ? int(std::round(std::ceil(freq) * sampleRate / freq)) : 1;
+
+        std::vector<float> data(size_t(settling + length));
+        for( size_t i = 0; i < data.size(); ++i )
+            data[i] = freq > 0.0 ? float(std::sin(juce::MathConstants<double>::twoPi * freq * double(i) / sampleRate)) : 1.f;
+
+        for( int start = 0; start < int(data.size()); start += 512 )
+            process(data.data() + start, juce::jmin(512, int(data.size()) - start));
+
+        if( freq <= 0.0 )
+            return double(std::abs(data.back()));
+
+        double re = 0.0, im = 0.0;
+        for( int i = settling; i < settling + length; ++i )
+        {
+            const double phase = juce::MathConstants<double>::twoPi * freq * double(i) / sampleRate;
+            re += data[size_t(i)] * std::cos(phase);
+            im += data[size_t(i)] * std::sin(phase);
+        }
+        return 2.0 * std::sqrt(re * re + im * im) / length;
+    };
+
+    auto toDecibels = [](double gain) { return juce::Decibels::gainToDecibels(gain, -200.0); };
+
+    //the parallel sections have to reach at least the cascade's attenuation (within 1 dB),
+    //DC has to be gone through the low cuts
+    constexpr double tolerance = 1.0, dcFloor = -120.0;
+    int failures = 0;
+
+    std::cout << "band     cut Hz  slope  rate Hz   at Hz  cascade dB  parallel dB" << std::endl;
+    for( const auto& c : cases )
+    {
+        DspKernels::Biquad sections[4];
+        const int numSections = EQEngine::designCut(c.lowCut, c.cutFreq, c.slope, c.sampleRate, sections);
+
+        double biquads[4][5];
+        for( int i = 0; i < numSections; ++i )
+        {
+            const double coefficients[5] = { sections[i].b0, sections[i].b1, sections[i].b2, sections[i].a1, sections[i].a2 };
+            std::copy(std::begin(coefficients), std::end(coefficients), biquads[i]);
+        }
+
+        float state[4][2] = {};
+        const double cascade = toDecibels(measure([&](float* data, int numSamples)
+        {
+            DspKernels::get().processCascade(data, numSamples, sections, state, numSections);
+        }, c.sampleRate, c.testFreq));
+
+        ParallelCutFilter parallel;
+        parallel.setCoefficients(biquads, numSections);
+        const double parallelResponse = toDecibels(measure([&](float* data, int numSamples)
+        {
+            parallel.process(data, numSamples);
+        }, c.sampleRate, c.testFreq));
+
+        const bool failed = c.testFreq > 0.0 ? parallelResponse > cascade + tolerance : parallelResponse > dcFloor;
+        failures += failed ? 1 : 0;
+
+        std::cout << juce::String(c.lowCut ? "low cut" : "high cut").paddedRight(' ', 8)
+                  << juce::String(c.cutFreq, 0).paddedLeft(' ', 7)
+                  << juce::String(12 * (int(c.slope) + 1)).paddedLeft(' ', 7)
+                  << juce::String(c.sampleRate, 0).paddedLeft(' ', 9)
+                  << juce::String(c.testFreq, 0).paddedLeft(' ', 8)
+                  << juce::String(cascade, 1).paddedLeft(' ', 12)
+                  << juce::String(parallelResponse, 1).paddedLeft(' ', 13)
+                  << (failed ? "  FAILED" : "") << std::endl;
+    }
+
+    if( failures > 0 )
+        juce::ConsoleApplication::fail(juce::String(failures) + " of " + juce::String(int(cases.size()))
+                                       + " cases don't match the cascade");
+
+    std::cout << "all " << cases.size() << " cases match the cascade" << std::endl;
+}
+
+//==============================================================================
+//time the executions of the realtime cascade over a range of block sizes
+static void benchmarkCascade(const juce::ArgumentList& args)
+{
+    auto settings = parseChainSettings(args);
+    //a busy chain by default, every band active with the steepest slopes
+    if( ! args.containsOption("--lowcut") )
+        settings.lowCutFreq = 80.f;
+    if( ! args.containsOption("--highcut") )
+        settings.highCutFreq = 12000.f;
+    if( ! args.containsOption("--lowcut-slope") )
+        settings.lowCutSlope = Slope_48;
+    if( ! args.containsOption("--highcut-slope") )
+        settings.highCutSlope = Slope_48;
+    if( ! args.containsOption("--gain") )
+        settings.peakGainInDecibels = 6.f;
+
+    const double sampleRate = args.containsOption("--rate") ? args.getValueForOption("--rate").getDoubleValue() : 48000.0;
+    const int numChannels = args.containsOption("--channels") ? juce::jmax(1, args.getValueForOption("--channels").getIntValue()) : 2;
+
+    if( args.containsOption("--isa") && ! DspKernels::forceVariant(args.getValueForOption("--isa").toRawUTF8()) )
+        juce::ConsoleApplication::fail("Kernel variant not available: " + args.getValueForOption("--isa"));
+
+    std::vector<DspKernels::Biquad> stages;
+    auto add = [&stages](const juce::dsp::IIR::Coefficients<float>& coefficients)
+    {
+        auto* c = coefficients.getRawCoefficients();
+        stages.push_back({ c[0], c[1], c[2], c[3], c[4] });
+    };
+    for( auto* coefficients : makeLowCutFilter(settings, sampleRate) )
+        add(*coefficients);
+    add(*makePeakFilter(settings, sampleRate));
+    for( auto* coefficients : makeHighCutFilter(settings, sampleRate) )
+        add(*coefficients);
+
+    using Execution = DspKernels::Execution;
+    const Execution executions[] = { Execution::Stages, Execution::Tiled, Execution::Fused };
+    const char* names[] = { "stages", "tiled", "fused" };
+
+    std::cout << "kernels: " << DspKernels::getActiveVariantName() << ", " << stages.size() << " stages, "
+              << numChannels << " channels" << std::endl
+              << "block      stages ns   tiled ns    fused ns   (per sample and channel)" << std::endl;
+
+    //smallest block size from which an execution beats stage by stage passes for good
+    int crossover[3] = { 0, 0, 0 };
+    juce::Random random;
+
+    for( int blockSize = 1; blockSize <= 65536; blockSize *= 2 )
+    {
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        for( int ch = 0; ch < numChannels; ++ch )
+            for( int i = 0; i < blockSize; ++i )
+                buffer.setSample(ch, i, random.nextFloat() * 2.f - 1.f);
+
+        double nanoseconds[3];
+        for( int e = 0; e < 3; ++e )
+        {
+            std::vector<float> state(2 * stages.size() * size_t(numChannels), 0.f);
+            auto* states = reinterpret_cast<float (*)[2]>(state.data());
+
+            //same amount of audio for every block size, best of three runs
+            const juce::int64 samplesPerRun = 1 << 22;
+            double best = std::numeric_limits<double>::max();
+            for( int run = 0; run < 3; ++run )
+            {
+                const auto start = juce::Time::getHighResolutionTicks();
+                for( juce::int64 done = 0; done < samplesPerRun; done += blockSize )
+                    for( int ch = 0; ch < numChannels; ++ch )
+                        DspKernels::processCascade(executions[e], buffer.getWritePointer(ch), blockSize,
+                                                   stages.data(), states + ch * int(stages.size()), int(stages.size()));
+                const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                best = juce::jmin(best, seconds * 1.0e9 / double(samplesPerRun * numChannels));
+            }
+            nanoseconds[e] = best;
+        }
+
+        for( int e = 1; e < 3; ++e )
+        {
+            if( nanoseconds[e] < nanoseconds[0] && crossover[e] == 0 )
+                crossover[e] = blockSize;
+            else if( nanoseconds[e] >= nanoseconds[0] )
+                crossover[e] = 0;
+        }
+
+        std::cout << juce::String(blockSize).paddedRight(' ', 10)
+                  << juce::String(nanoseconds[0], 2).paddedLeft(' ', 10)
+                  << juce::String(nanoseconds[1], 2).paddedLeft(' ', 12)
+                  << juce::String(nanoseconds[2], 2).paddedLeft(' ', 12) << std::endl;
+    }
+
+    for( int e = 1; e < 3; ++e )
+    {
+        std::cout << names[e] << " vs stages: ";
+        if( crossover[e] > 0 )
+            std::cout << "faster from " << crossover[e] << " samples per block" << std::endl;
+        else
+            std::cout << "no crossover" << std::endl;
+    }
+}
+
+//==============================================================================
+//time every kernel in every variant this CPU can run, the numbers the variants in DspKernels.cpp are picked from
+static void benchmarkKernels(const juce::ArgumentList& args)
+{
+    const int numSamples = args.containsOption("--block") ? juce::jmax(1, args.getValueForOption("--block").getIntValue()) : 256;
+    const int numStages = EQEngine::maxStages;
+
+    //a stable resonant stage, the numbers don't depend on the coefficients
+    DspKernels::Biquad stages[numStages];
+    DspKernels::LaneBiquad laneStages[numStages];
+    for( int n = 0; n < numStages; ++n )
+    {
+        stages[n] = { 0.2f, 0.3f, 0.2f, -0.5f, 0.2f };
+        for( int l = 0; l < DspKernels::laneWidth; ++l )
+        {
+            laneStages[n].b0[l] = 0.2f; laneStages[n].b1[l] = 0.3f; laneStages[n].b2[l] = 0.2f;
+            laneStages[n].a1[l] = -0.5f; laneStages[n].a2[l] = 0.2f;
+        }
+    }
+
+    juce::Random random;
+    std::vector<float> data(size_t(numSamples) * DspKernels::laneWidth);
+    for( auto& x : data )
+        x = random.nextFloat() * 2.f - 1.f;
+
+    std::vector<double> cosW(size_t(numSamples)), cos2W(size_t(numSamples)), squaredMagnitudes(size_t(numSamples), 1.0);
+    for( int i = 0; i < numSamples; ++i )
+    {
+        const double w = juce::MathConstants<double>::pi * i / numSamples;
+        cosW[size_t(i)] = std::cos(w);
+        cos2W[size_t(i)] = std::cos(2.0 * w);
+    }
+
+    //best of five runs of about 20 ms each, in nanoseconds per call
+    auto time = [](auto&& kernel)
+    {
+        int calls = 1;
+        for( ;; calls *= 2 )
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            for( int i = 0; i < calls; ++i )
+                kernel();
+            if( juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) > 0.02 )
+                break;
+        }
+
+        double best = std::numeric_limits<double>::max();
+        for( int run = 0; run < 5; ++run )
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            for( int i = 0; i < calls; ++i )
+                kernel();
+            const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            best = juce::jmin(best, seconds * 1.0e9 / calls);
+        }
+        return best;
+    };
+
+    std::cout << numSamples << " samples, " << numStages << " stages, in use: " << DspKernels::getActiveVariantName() << std::endl
+              << "variant    stages ns    fused ns  lanes ns/sample/lane  magnitudes ns" << std::endl;
+
+    for( int v = 0; v < DspKernels::getNumVariants(); ++v )
+    {
+        auto* kernels = DspKernels::getVariant(v);
+        if( kernels == nullptr )
+            continue;
+
+        float state[numStages][2] = {};
+        DspKernels::LaneState laneState[numStages] = {};
+
+        const double stagesTime = time([&] { kernels->processCascade(data.data(), numSamples, stages, state, numStages); });
+        const double fusedTime = time([&] { kernels->processCascadeFused(data.data(), numSamples, stages, state, numStages); });
+        const double lanesTime = time([&] { kernels->processLanes(data.data(), numSamples, laneStages, laneState, numStages); });
+        const double magnitudesTime = time([&]
+        {
+            kernels->multiplySquaredMagnitudes(stages[0], cosW.data(), cos2W.data(), squaredMagnitudes.data(), numSamples);
+            //keep the products from running off to infinity
+            squaredMagnitudes[0] = 1.0;
+        });
+
+        std::cout << juce::String(kernels->name).paddedRight(' ', 10)
+                  << juce::String(stagesTime, 0).paddedLeft(' ', 10)
+                  << juce::String(fusedTime, 0).paddedLeft(' ', 12)
+                  << juce::String(lanesTime / (numSamples * DspKernels::laneWidth), 2).paddedLeft(' ', 22)
+                  << juce::String(magnitudesTime, 0).paddedLeft(' ', 15) << std::endl;
+    }
+}
+
+//==============================================================================
+//time the batch engine on many independent streams against one cascade per channel (what as many plugin instances do)
+static void benchmarkBatch(const juce::ArgumentList& args)
+{
+    auto getInt = [&args](const juce::String& option, int defaultValue)
+    {
+        return args.containsOption(option) ? juce::jmax(1, args.getValueForOption(option).getIntValue()) : defaultValue;
+    };
+
+    const int numStreams = getInt("--streams", 256);
+    const int numChannels = getInt("--channels", 2);
+    const int blockSize = getInt("--block", 512);
+    const int numThreads = getNumThreads(args);
+    const double sampleRate = args.containsOption("--rate") ? args.getValueForOption("--rate").getDoubleValue() : 48000.0;
+    const double audioSeconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 10.0;
+
+    if( args.containsOption("--isa") && ! DspKernels::forceVariant(args.getValueForOption("--isa").toRawUTF8()) )
+        juce::ConsoleApplication::fail("Kernel variant not available: " + args.getValueForOption("--isa"));
+
+    EQEngine engine(sampleRate, blockSize, std::vector<int>(size_t(numStreams), numChannels));
+
+    //every stream gets its own settings, slopes spread over all four
+    juce::Random random(1);
+    std::vector<ChainSettings> settings(size_t(numStreams));
+    for( int s = 0; s < numStreams; ++s )
+    {
+        auto& streamSettings = settings[size_t(s)];
+        streamSettings = EQEngine::getDefaultSettings();
+        streamSettings.lowCutFreq = 40.f + 200.f * random.nextFloat();
+        streamSettings.highCutFreq = 6000.f + 12000.f * random.nextFloat();
+        streamSettings.peakFreq = 200.f + 4000.f * random.nextFloat();
+        streamSettings.peakGainInDecibels = 12.f * random.nextFloat() - 6.f;
+        streamSettings.lowCutSlope = static_cast<Slope>(random.nextInt(4));
+        streamSettings.highCutSlope = static_cast<Slope>(random.nextInt(4));
+        engine.setSettings(s, streamSettings);
+    }
+
+    juce::AudioBuffer<float> audio(numStreams * numChannels, blockSize);
+    for( int ch = 0; ch < audio.getNumChannels(); ++ch )
+        for( int i = 0; i < blockSize; ++i )
+            audio.setSample(ch, i, random.nextFloat() * 2.f - 1.f);
+
+    //streams[s] points at the channels of stream s
+    auto* const* channels = audio.getArrayOfWritePointers();
+    std::vector<float* const*> streams;
+    for( int s = 0; s < numStreams; ++s )
+        streams.push_back(channels + s * numChannels);
+
+    const int numBlocks = juce::jmax(1, int(audioSeconds * sampleRate / blockSize));
+    juce::ThreadPool pool(numThreads);
+
+    //every thread takes an equal share of the batches of each block
+    auto start = juce::Time::getHighResolutionTicks();
+    for( int block = 0; block < numBlocks; ++block )
+    {
+        std::atomic<int> remaining{numThreads};
+        juce::WaitableEvent finished;
+
+        for( int t = 0; t < numThreads; ++t )
+        {
+            pool.addJob([&, t]
+            {
+                for( int batch = t; batch < engine.getNumBatches(); batch += numThreads )
+                    engine.processBatch(batch, streams.data(), blockSize);
+
+                if( --remaining == 0 )
+                    finished.signal();
+            });
+        }
+
+        finished.wait();
+    }
+    const auto engineSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+    //the same streams through one fused cascade per channel, on one thread
+    std::vector<std::vector<DspKernels::Biquad>> cascades;
+    for( const auto& streamSettings : settings )
+    {
+        DspKernels::Biquad stages[EQEngine::maxStages];
+        const int length = EQEngine::design(streamSettings, sampleRate, stages);
+        cascades.emplace_back(stages, stages + length);
+    }
+    std::vector<float> state(size_t(numStreams * numChannels * EQEngine::maxStages * 2), 0.f);
+    auto* states = reinterpret_cast<float (*)[2]>(state.data());
+
+    start = juce::Time::getHighResolutionTicks();
+    for( int block = 0; block < numBlocks; ++block )
+        for( int s = 0; s < numStreams; ++s )
+            for( int ch = 0; ch < numChannels; ++ch )
+                DspKernels::processCascade(DspKernels::Execution::Fused, channels[s * numChannels + ch], blockSize,
+                                           cascades[size_t(s)].data(), states + (s * numChannels + ch) * EQEngine::maxStages,
+                                           int(cascades[size_t(s)].size()));
+    const auto cascadeSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+    const double processedSeconds = double(numBlocks) * blockSize / sampleRate;
+    const double channelSamples = double(numBlocks) * blockSize * numStreams * numChannels;
+    std::cout << "kernels: " << DspKernels::getActiveVariantName() << ", " << numStreams << " streams of "
+              << numChannels << " channels, " << engine.getNumBatches() << " batches of " << EQEngine::laneWidth << " lanes" << std::endl
+              << "engine: " << engineSeconds * 1.0e9 / channelSamples << " ns per sample and channel on "
+              << numThreads << " threads, " << processedSeconds / engineSeconds << "x realtime for all streams" << std::endl
+              << "one cascade per channel: " << cascadeSeconds * 1.0e9 / channelSamples << " ns per sample and channel on 1 thread, "
+              << processedSeconds / cascadeSeconds << "x realtime for all streams" << std::endl;
+}
+
+//==============================================================================
+//time one processBlock call of the plugin at the block sizes of live rigs, against the filtering alone
+static void benchmarkBlocks(const juce::ArgumentList& args)
+{
+    //the processor broadcasts changes and posts async updates, that needs a message manager
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ScopedNoDenormals noDenormals;
+
+    auto settings = parseChainSettings(args);
+    //a busy chain by default, every band active with the steepest slopes
+    if( ! args.containsOption("--lowcut") )
+        settings.lowCutFreq = 80.f;
+    if( ! args.containsOption("--highcut") )
+        settings.highCutFreq = 12000.f;
+    if( ! args.containsOption("--lowcut-slope") )
+        settings.lowCutSlope = Slope_48;
+    if( ! args.containsOption("--highcut-slope") )
+        settings.highCutSlope = Slope_48;
+    if( ! args.containsOption("--gain") )
+        settings.peakGainInDecibels = 6.f;
+
+    const double sampleRate = args.containsOption("--rate") ? args.getValueForOption("--rate").getDoubleValue() : 48000.0;
+
+    std::cout << "kernels: " << DspKernels::getActiveVariantName() << ", stereo" << std::endl
+              << "block    processBlock ns  filtering ns   overhead ns  automated ns   (per call)" << std::endl;
+
+    juce::Random random;
+    for( int blockSize : { 16, 32, 64, 128, 256 } )
+    {
+        _3BandEQAudioProcessor processor;
+        processor.setChainSettings(settings);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        for( int ch = 0; ch < 2; ++ch )
+            for( int i = 0; i < blockSize; ++i )
+                buffer.setSample(ch, i, random.nextFloat() * 2.f - 1.f);
+        juce::MidiBuffer midi;
+
+        //same amount of audio for every block size, best of three runs
+        const int numCalls = (1 << 21) / blockSize;
+        auto time = [numCalls](auto&& call)
+        {
+            double best = std::numeric_limits<double>::max();
+            for( int run = 0; run < 3; ++run )
+            {
+                const auto start = juce::Time::getHighResolutionTicks();
+                for( int n = 0; n < numCalls; ++n )
+                    call();
+                const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                best = juce::jmin(best, seconds * 1.0e9 / numCalls);
+            }
+            return best;
+        };
+
+        const double perCall = time([&] { processor.processBlock(buffer, midi); });
+
+        //the same stages without anything around them, designed once
+        DspKernels::Biquad stages[EQEngine::maxStages];
+        const int length = EQEngine::design(settings, sampleRate, stages);
+        float state[2][EQEngine::maxStages][2] = {};
+        const double filtering = time([&]
+        {
+            for( int ch = 0; ch < 2; ++ch )
+                DspKernels::processCascade(DspKernels::Execution::Automatic, buffer.getWritePointer(ch), blockSize,
+                                           stages, state[ch], length);
+        });
+
+        //host automation moves the peak gain every block, so every call reads the parameters and updates the filters
+        auto* gain = processor.apvts.getParameter("Peak Gain");
+        bool up = false;
+        const double automated = time([&]
+        {
+            gain->setValueNotifyingHost((up = ! up) ? 0.6f : 0.4f);
+            processor.processBlock(buffer, midi);
+        });
+
+        processor.releaseResources();
+
+        std::cout << juce::String(blockSize).paddedRight(' ', 8)
+                  << juce::String(perCall, 1).paddedLeft(' ', 14)
+                  << juce::String(filtering, 1).paddedLeft(' ', 14)
+                  << juce::String(perCall - filtering, 1).paddedLeft(' ', 14)
+                  << juce::String(automated, 1).paddedLeft(' ', 14) << std::endl;
+    }
+}
+
+//==============================================================================
+//time loading a session with many instances of the plugin: construction, state restore and the prepares hosts make
+static void benchmarkSession(const juce::ArgumentList& args)
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const double sampleRate = args.containsOption("--rate") ? args.getValueForOption("--rate").getDoubleValue() : 48000.0;
+    const int blockSize = 512;
+
+    std::vector<int> instanceCounts { 1, 100, 1000 };
+    if( args.containsOption("--instances") )
+        instanceCounts = { juce::jmax(1, args.getValueForOption("--instances").getIntValue()) };
+
+    //a few different saved states, like the tracks of a real session
+    std::vector<juce::MemoryBlock> states;
+    {
+        juce::Random random(42);
+        for( int n = 0; n < 8; ++n )
+        {
+            ChainSettings settings = EQEngine::getDefaultSettings();
+            settings.lowCutFreq = 20.f + random.nextFloat() * 200.f;
+            settings.highCutFreq = 5000.f + random.nextFloat() * 15000.f;
+            settings.peakFreq = 100.f + random.nextFloat() * 8000.f;
+            settings.peakGainInDecibels = random.nextFloat() * 24.f - 12.f;
+            settings.lowCutSlope = static_cast<Slope>(n % 4);
+            settings.highCutSlope = static_cast<Slope>((n / 2) % 4);
+
+            _3BandEQAudioProcessor processor;
+            processor.setChainSettings(settings);
+            states.emplace_back();
+            processor.getStateInformation(states.back());
+        }
+    }
+
+    std::cout << "instances   construct ms  restore ms  prepare ms  same spec ms  new rate ms  (us per instance)" << std::endl;
+
+    for( int numInstances : instanceCounts )
+    {
+        std::vector<std::unique_ptr<_3BandEQAudioProcessor>> processors;
+        processors.reserve(size_t(numInstances));
+
+        auto time = [](auto&& phase)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            phase();
+            return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1.0e3;
+        };
+
+        const double construct = time([&]
+        {
+            for( int n = 0; n < numInstances; ++n )
+                processors.push_back(std::make_unique<_3BandEQAudioProcessor>());
+        });
+
+        //hosts restore the state before they prepare
+        const double restore = time([&]
+        {
+            for( int n = 0; n < numInstances; ++n )
+            {
+                const auto& state = states[size_t(n) % states.size()];
+                processors[size_t(n)]->setStateInformation(state.getData(), int(state.getSize()));
+            }
+        });
+
+        auto prepareAll = [&](double rate)
+        {
+            for( auto& processor : processors )
+            {
+                processor->setRateAndBufferSizeDetails(rate, blockSize);
+                processor->prepareToPlay(rate, blockSize);
+            }
+        };
+
+        const double prepare = time([&] { prepareAll(sampleRate); });
+        //e.g. starting the transport or resetting the audio device, nothing changed
+        const double sameSpec = time([&] { prepareAll(sampleRate); });
+        //the session is switched to another sample rate
+        const double newRate = time([&] { prepareAll(sampleRate == 48000.0 ? 44100.0 : 48000.0); });
+
+        const double perInstance = 1.0e3 / numInstances;
+        auto column = [perInstance](double ms, int width)
+        {
+            return (juce::String(ms, 2) + " (" + juce::String(ms * perInstance, 1) + ")").paddedLeft(' ', width);
+        };
+        std::cout << juce::String(numInstances).paddedRight(' ', 9)
+                  << column(construct, 15) << column(restore, 12) << column(prepare, 12)
+                  << column(sameSpec, 14) << column(newRate, 13) << std::endl;
+
+        //destruction is part of closing the session, not of loading it
+        processors.clear();
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ConsoleApplication app;
+
+    app.addHelpCommand("--help|-h", "EQTool - offline processing with the 3BandEQ chain", true);
+
+    app.addCommand({ "render",
+                     "render <input> <output> [--threads=n] [--verify] [chain options]",
+                     "Filters a file on all cores by splitting it into warmed-up segments.",
+                     "Chain options: --lowcut=Hz --lowcut-slope=dB/Oct --peak=Hz --gain=dB --q=Q "
+                     "--highcut=Hz --highcut-slope=dB/Oct\n"
+                     "--verify also renders sequentially and prints the speedup and the largest difference.",
+                     renderFile });
+
+    app.addCommand({ "match",
+                     "match <source> <reference> [--threads=n] [--rate=Hz]",
+                     "Fits the chain settings that make the source sound like the reference.",
+                     "Measures the long-term average spectra of both files on all cores and prints the fitted\n"
+                     "settings as chain options for render. --rate designs the filters for another sample rate\n"
+                     "than the source's.",
+                     matchFiles });
+
+    app.addCommand({ "parallel",
+                     "parallel",
+                     "Checks the parallel realization of the cut filters against the cascade.",
+                     "Measures both at a quarter of the cut frequency and at DC (low cuts at 20 and 40 Hz) and far\n"
+                     "above the cut frequency (high cuts at 200 Hz and 15 kHz), for every slope at 44.1 to 192 kHz.\n"
+                     "Fails if the parallel sections attenuate less than the cascade (by more than 1 dB) or pass DC\n"
+                     "above -120 dB.",
+                     checkParallelCutFilters });
+
+    app.addCommand({ "bench",
+                     "bench [--channels=n] [--rate=Hz] [--isa=name] [chain options]",
+                     "Times stage by stage, tiled and fused execution of the realtime cascade per block size.",
+                     "Prints nanoseconds per sample and channel for block sizes from 1 to 65536 and the block size\n"
+                     "from which tiled and fused execution beat stage by stage passes. Without chain options all\n"
+                     "bands are active with the steepest slopes. --isa forces a kernel variant (generic, avx2).",
+                     benchmarkCascade });
+
+    app.addCommand({ "kernels",
+                     "kernels [--block=n]",
+                     "Times every DSP kernel in every variant this CPU can run.",
+                     "Prints nanoseconds per call of stage by stage and fused cascades of 9 stages, the lane kernel per\n"
+                     "sample and lane, and the magnitude kernel, on blocks of 256 samples unless --block is given.\n"
+                     "The variants the plugin uses per kernel are picked from these numbers.",
+                     benchmarkKernels });
+
+    app.addCommand({ "batch",
+                     "batch [--streams=n] [--channels=n] [--block=n] [--rate=Hz] [--seconds=s] [--threads=n] [--isa=name]",
+                     "Times the batch engine on many independent streams, each with its own settings.",
+                     "Runs the streams' batches on a thread pool and compares the time with one cascade per channel\n"
+                     "on a single thread. Defaults: 256 stereo streams, 512 sample blocks, 10 s of audio at 48 kHz.",
+                     benchmarkBatch });
+
+    app.addCommand({ "blocks",
+                     "blocks [--rate=Hz] [chain options]",
+                     "Times one processBlock call of the plugin at small block sizes against the filtering alone.",
+                     "Prints nanoseconds per stereo call for blocks of 16 to 256 samples: the whole processBlock with\n"
+                     "static parameters, the bare cascades, the difference (the fixed cost per call) and processBlock\n"
+                     "with the peak gain automated every block. Without chain options all bands are active with the\n"
+                     "steepest slopes.",
+                     benchmarkBlocks });
+
+    app.addCommand({ "session",
+                     "session [--instances=n] [--rate=Hz]",
+                     "Times loading a session with many plugin instances.",
+                     "Prints milliseconds (and microseconds per instance) for constructing the processors, restoring\n"
+                     "their states, the first prepareToPlay, a second one with the same spec and one at a new sample\n"
+                     "rate. Runs 1, 100 and 1000 instances unless --instances is given.",
+                     benchmarkSession });
+
+    return app.findAndRunCommand(argc, argv);
+}
@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+    BiquadCascade.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "BiquadCascade.h"
+
+BiquadCascade::BiquadCascade()
+{
+    reset();
+}
+
+void BiquadCascade::setCoefficients(const DspKernels::Biquad (&designed)[EQEngine::maxStages], Slope lowCutSlope, Slope highCutSlope)
+{
+    DspKernels::Biquad newStages[maxStages];
+    int newSlots[maxStages] = {};
+    int count = 0;
+
+    //the engine has the peak first, then low cut and high cut sections taking turns
+    for( int i = 0; i <= int(lowCutSlope); ++i )
+    {
+        newStages[count] = designed[1 + 2 * i];
+        newSlots[count++] = i;
+    }
+
+    newStages[count] = designed[0];
+    newSlots[count++] = 4;
+
+    for( int i = 0; i <= int(highCutSlope); ++i )
+    {
+        newStages[count] = designed[2 + 2 * i];
+        newSlots[count++] = 5 + i;
+    }
+
+    setStages(newStages, newSlots, count);
+}
+
+void BiquadCascade::setStages(const DspKernels::Biquad* newStages, const int* newSlots, int count)
+{
+    float newState[maxStages][2] = {};
+
+    for( int n = 0; n < count; ++n )
+    {
+        //same stage as before, carry its state over
+        for( int i = 0; i < numStages; ++i )
+        {
+            if( slots[i] == newSlots[n] )
+            {
+                newState[n][0] = state[i][0];
+                newState[n][1] = state[i][1];
+                break;
+            }
+        }
+
+        if( newSlots[n] == 4 )
+            peakStage = n;
+    }
+
+    std::copy(newStages, newStages + count, std::begin(stages));
+    std::copy(&newState[0][0], &newState[0][0] + 2 * maxStages, &state[0][0]);
+    std::fill(std::begin(slots), std::end(slots), 0);
+    std::copy(newSlots, newSlots + count, std::begin(slots));
+    numStages = count;
+}
+
+void BiquadCascade::reset()
+{
+    std::fill(&state[0][0], &state[0][0] + 2 * maxStages, 0.f);
+}
+
+void BiquadCascade::process(float* data, int numSamples)
+{
+    DspKernels::processCascade(execution, data, numSamples, stages, state, numStages);
+}
+
+void BiquadCascade::process(float* data, int numSamples, bool lowCut, bool peak, bool highCut)
+{
+    if( lowCut && peak && highCut )
+    {
+        process(data, numSamples);
+        return;
+    }
+
+    auto run = [&](int first, int end)
+    {
+        if( end > first )
+            DspKernels::processCascade(execution, data, numSamples, stages + first, state + first, end - first);
+    };
+
+    if( lowCut )
+        run(0, peakStage);
+    if( peak )
+        run(peakStage, peakStage + 1);
+    if( highCut )
+        run(peakStage + 1, numStages);
+}
+
+bool BiquadCascade::isPeakNeutral() const
+{
+    if( peakStage >= numStages )
+        return true;
+
+    //not exactly zero: with fused multiply-adds b1 x - a1 y leaves a rounding error in the state even at 0 dB
+    constexpr float silence = 1.0e-6f;
+    const auto& c = stages[peakStage];
+    return c.b0 == 1.f && c.b1 == c.a1 && c.b2 == c.a2
+        && std::abs(state[peakStage][0]) < silence && std::abs(state[peakStage][1]) < silence;
+}
+
+void BiquadCascade::processPeak(float* data, int numSamples)
+{
+    if( peakStage < numStages )
+        DspKernels::get().processCascade(data, numSamples, stages + peakStage, state + peakStage, 1);
+}
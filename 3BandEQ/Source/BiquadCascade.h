@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    BiquadCascade.h
+    Created: 18 Oct 2026
+
+    Realtime filter chain of one channel as a flat array of biquads
+    (low cut, peak, high cut), processed by the dispatched DSP kernels.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainSettings.h"
+#include "DspKernels.h"
+#include "EQEngine.h"
+
+class BiquadCascade
+{
+public:
+  //up to 4 low cut biquads, the peak filter and up to 4 high cut biquads
+  static constexpr int maxStages = 9;
+
+  BiquadCascade();
+
+  //copy stages designed by EQEngine::design into the cascade (no allocations)
+  //the slopes tell which stages belong to which band, stages that were active before keep their state
+  void setCoefficients(const DspKernels::Biquad (&designed)[EQEngine::maxStages], Slope lowCutSlope, Slope highCutSlope);
+
+  void reset();
+
+  //how the stages walk over a block
+  void setExecution(DspKernels::Execution newExecution) { execution = newExecution; }
+
+  //run all stages
+  void process(float* data, int numSamples);
+  //run only the stages of the chosen bands, the others keep their state untouched
+  void process(float* data, int numSamples, bool lowCut, bool peak, bool highCut);
+  //run only the peak stage (when the cut filters are realized elsewhere)
+  void processPeak(float* data, int numSamples);
+
+  int getNumStages() const { return numStages; }
+
+  //the peak stage passes every signal through unchanged: it's at 0 dB (numerator equal to the denominator)
+  //and what's left of its state is below -120 dB, so skipping it changes the output by less than that
+  bool isPeakNeutral() const;
+
+private:
+  DspKernels::Biquad stages[maxStages];
+  float state[maxStages][2];
+  //position of every stage in the full chain (low cut 0-3, peak 4, high cut 5-8)
+  int slots[maxStages] = {};
+  int numStages = 0, peakStage = 0;
+  DspKernels::Execution execution = DspKernels::Execution::Automatic;
+
+  //take over new stages at the given slots, stages at the same slot as before keep their state
+  void setStages(const DspKernels::Biquad* newStages, const int* newSlots, int count);
+};
@@ -0,0 +1,38 @@
+/*
+  ==============================================================================
+
+    ChainSettings.h
+    Created: 18 Oct 2026
+
+    Settings of one filter chain. Plain C++ without JUCE, so the engine can
+    be used outside of the plugin.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+//Slope setting
+enum Slope
+{
+  Slope_12,
+  Slope_24,
+  Slope_36,
+  Slope_48
+};
+
+//All Parameters of the Chain
+struct ChainSettings
+{
+  float peakFreq{0}, peakGainInDecibels{0}, peakQuality{1.f};
+  float lowCutFreq{0}, highCutFreq{0};
+  Slope lowCutSlope{Slope::Slope_12}, highCutSlope{Slope::Slope_12};
+
+  bool operator==(const ChainSettings& other) const
+  {
+    return peakFreq == other.peakFreq && peakGainInDecibels == other.peakGainInDecibels && peakQuality == other.peakQuality
+        && lowCutFreq == other.lowCutFreq && highCutFreq == other.highCutFreq
+        && lowCutSlope == other.lowCutSlope && highCutSlope == other.highCutSlope;
+  }
+  bool operator!=(const ChainSettings& other) const { return ! (*this == other); }
+};
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    CoefficientCache.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "CoefficientCache.h"
+
+size_t CoefficientSet::getMemoryUsage() const
+{
+    size_t bytes = sizeof(CoefficientSet) + size_t(coefficients.size()) * sizeof(void*);
+
+    for( auto* c : coefficients )
+        bytes += CoefficientCache::getCoefficientsMemoryUsage(int(c->getFilterOrder()));
+
+    return bytes;
+}
+
+bool CoefficientKey::operator<(const CoefficientKey& other) const
+{
+    return std::tie(band, freq, quality, gainInDecibels, slope, sampleRate)
+         < std::tie(other.band, other.freq, other.quality, other.gainInDecibels, other.slope, other.sampleRate);
+}
+
+//==============================================================================
+template<typename DesignFunction>
+CoefficientSet::Ptr CoefficientCache::getOrCreate(const CoefficientKey& key, DesignFunction&& design)
+{
+    {
+        const juce::ScopedLock sl(lock);
+        auto it = entries.find(key);
+        if( it != entries.end() )
+            return it->second;
+    }
+
+    //design outside of the lock so other instances don't have to wait for it
+    CoefficientSet::Ptr set = new CoefficientSet();
+    design(set->coefficients);
+
+    const juce::ScopedLock sl(lock);
+    if( entries.size() >= purgeThreshold )
+        purgeUnused();
+
+    //if another instance inserted the same key in the meantime, its set is used and ours is dropped
+    return entries.emplace(key, set).first->second;
+}
+
+CoefficientSet::Ptr CoefficientCache::getLowCut(const ChainSettings& chainSettings, double sampleRate)
+{
+    CoefficientKey key;
+    key.band = ChainPositions::LowCut;
+    key.freq = chainSettings.lowCutFreq;
+    key.slope = chainSettings.lowCutSlope;
+    key.sampleRate = sampleRate;
+
+    return getOrCreate(key, [&](auto& coefficients)
+    {
+        coefficients = makeLowCutFilter(chainSettings, sampleRate);
+    });
+}
+
+CoefficientSet::Ptr CoefficientCache::getPeak(const ChainSettings& chainSettings, double sampleRate)
+{
+    CoefficientKey key;
+    key.band = ChainPositions::Peak;
+    key.freq = chainSettings.peakFreq;
+    key.quality = chainSettings.peakQuality;
+    key.gainInDecibels = chainSettings.peakGainInDecibels;
+    key.sampleRate = sampleRate;
+
+    return getOrCreate(key, [&](auto& coefficients)
+    {
+        coefficients.add(makePeakFilter(chainSettings, sampleRate));
+    });
+}
+
+CoefficientSet::Ptr CoefficientCache::getHighCut(const ChainSettings& chainSettings, double sampleRate)
+{
+    CoefficientKey key;
+    key.band = ChainPositions::HighCut;
+    key.freq = chainSettings.highCutFreq;
+    key.slope = chainSettings.highCutSlope;
+    key.sampleRate = sampleRate;
+
+    return getOrCreate(key, [&](auto& coefficients)
+    {
+        coefficients = makeHighCutFilter(chainSettings, sampleRate);
+    });
+}
+
+void CoefficientCache::purgeUnused()
+{
+    const juce::ScopedLock sl(lock);
+
+    for( auto it = entries.begin(); it != entries.end(); )
+    {
+        //a reference count of 1 means only the cache holds on to this set
+        if( it->second->getReferenceCount() == 1 )
+            it = entries.erase(it);
+        else
+            ++it;
+    }
+}
+
+int CoefficientCache::getNumEntries() const
+{
+    const juce::ScopedLock sl(lock);
+    return int(entries.size());
+}
+
+size_t CoefficientCache::getMemoryUsage() const
+{
+    const juce::ScopedLock sl(lock);
+
+    size_t bytes = sizeof(CoefficientCache);
+    for( auto& entry : entries )
+        bytes += sizeof(entry) + entry.second->getMemoryUsage();
+
+    return bytes;
+}
+
+size_t CoefficientCache::getCoefficientsMemoryUsage(int filterOrder)
+{
+    //the object itself plus its heap allocated array of 2 * order + 1 normalised coefficients
+    return sizeof(juce::dsp::IIR::Coefficients<float>) + size_t(2 * filterOrder + 1) * sizeof(float);
+}
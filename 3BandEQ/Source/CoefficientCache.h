@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    CoefficientCache.h
+    Created: 18 Oct 2026
+
+    Process-wide cache of designed filter coefficients for the message
+    thread users (the editors' response curves). Editors with the same
+    settings share one immutable set of coefficients instead of each
+    designing and owning their own copy. The audio thread never uses it,
+    the processor designs its cascades in place.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+
+//immutable set of designed coefficients
+//the peak filter has one entry, cut filters have one entry per biquad (slope + 1)
+struct CoefficientSet : juce::ReferenceCountedObject
+{
+  using Ptr = juce::ReferenceCountedObjectPtr<CoefficientSet>;
+
+  juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>> coefficients;
+
+  //approximate heap + object size of this set in bytes
+  size_t getMemoryUsage() const;
+};
+
+//everything a coefficient design depends on
+struct CoefficientKey
+{
+  ChainPositions band{ChainPositions::Peak};
+  float freq{0}, quality{0}, gainInDecibels{0};
+  Slope slope{Slope::Slope_12};
+  double sampleRate{0};
+
+  bool operator<(const CoefficientKey& other) const;
+};
+
+//thread-safe, reference-counted cache of coefficient sets
+//use it through juce::SharedResourcePointer<CoefficientCache> so all instances in the process share one cache
+class CoefficientCache
+{
+public:
+  CoefficientCache() = default;
+
+  //get (or design and insert) the coefficients for one band (locks and allocates, not for the audio thread)
+  CoefficientSet::Ptr getLowCut(const ChainSettings& chainSettings, double sampleRate);
+  CoefficientSet::Ptr getPeak(const ChainSettings& chainSettings, double sampleRate);
+  CoefficientSet::Ptr getHighCut(const ChainSettings& chainSettings, double sampleRate);
+
+  //remove all sets that aren't referenced by anyone but the cache
+  void purgeUnused();
+
+  int getNumEntries() const;
+  //approximate memory held by the cache in bytes
+  size_t getMemoryUsage() const;
+
+  //approximate size of one privately owned coefficients object of the given filter order
+  static size_t getCoefficientsMemoryUsage(int filterOrder);
+
+private:
+  template<typename DesignFunction>
+  CoefficientSet::Ptr getOrCreate(const CoefficientKey& key, DesignFunction&& design);
+
+  //above this many entries lookups sweep out unused sets before inserting
+  static constexpr size_t purgeThreshold = 512;
+
+  std::map<CoefficientKey, CoefficientSet::Ptr> entries;
+  juce::CriticalSection lock;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CoefficientCache)
+};
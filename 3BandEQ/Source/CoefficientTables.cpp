@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+    CoefficientTables.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "CoefficientTables.h"
+
+//frequency range of the cut filter parameters
+static constexpr float minFreq = 20.f, maxFreq = 20000.f;
+
+CutFilterTables::Table::Table(double sr, int res) : sampleRate(sr), resolution(res)
+{
+  numPoints = resolution == fullResolution ? int(maxFreq - minFreq) + 1 : juce::jmax(2, resolution);
+  //frequencies at or above nyquist can't be designed, lookups for them fall back to the direct design
+  while( numPoints > 0 && getFrequency(numPoints - 1) >= sampleRate * 0.5 )
+    --numPoints;
+}
+
+float CutFilterTables::Table::getFrequency(int point) const
+{
+  if( resolution == fullResolution )
+    return minFreq + float(point);
+
+  return juce::mapToLog10(float(point) / float(resolution - 1), minFreq, maxFreq);
+}
+
+size_t CutFilterTables::Table::getOffset(int point, Slope slope)
+{
+  //the biquads of one slope start after those of all lower slopes
+  const int firstBiquad = slope * (slope + 1) / 2;
+  return (size_t(point) * biquadsPerPoint + size_t(firstBiquad)) * coefficientsPerBiquad;
+}
+
+const float* CutFilterTables::Table::getBiquads(int bandIndex, int point, Slope slope) const
+{
+  return data[bandIndex].data() + getOffset(point, slope);
+}
+
+size_t CutFilterTables::Table::getMemoryUsage() const
+{
+  return sizeof(Table) + (data[0].size() + data[1].size()) * sizeof(float);
+}
+
+void CutFilterTables::Table::build()
+{
+  const auto start = juce::Time::getMillisecondCounterHiRes();
+
+  for( auto& d : data )
+    d.resize(size_t(numPoints) * biquadsPerPoint * coefficientsPerBiquad);
+
+  for( int point = 0; point < numPoints; ++point )
+  {
+    if( cancelled.load() )
+      return;
+
+    for( int s = Slope_12; s <= Slope_48; ++s )
+    {
+      const auto slope = static_cast<Slope>(s);
+
+      //only the band that's stored is designed, straight into its row
+      auto store = [&](int bandIndex, bool lowCut)
+      {
+        DspKernels::Biquad sections[4];
+        const int numSections = EQEngine::designCut(lowCut, getFrequency(point), slope, sampleRate, sections);
+
+        auto* dest = data[bandIndex].data() + getOffset(point, slope);
+        for( int i = 0; i < numSections; ++i, dest += coefficientsPerBiquad )
+        {
+          dest[0] = sections[i].b0;
+          dest[1] = sections[i].b1;
+          dest[2] = sections[i].b2;
+          dest[3] = sections[i].a1;
+          dest[4] = sections[i].a2;
+        }
+      };
+
+      store(0, true);
+      store(1, false);
+    }
+  }
+
+  buildTimeMs = juce::Time::getMillisecondCounterHiRes() - start;
+  ready.store(true, std::memory_order_release);
+}
+
+bool CutFilterTables::Table::lookup(ChainPositions band, float freq, Slope slope, DspKernels::Biquad* sections) const
+{
+  jassert(band == ChainPositions::LowCut || band == ChainPositions::HighCut);
+
+  //the rows are written before ready is set and never change afterwards
+  if( ! ready.load(std::memory_order_acquire) )
+    return false;
+
+  const int bandIndex = band == ChainPositions::LowCut ? 0 : 1;
+  const int numBiquads = slope + 1;
+  constexpr int n = coefficientsPerBiquad;
+
+  auto set = [sections](int i, const float* c)
+  {
+    sections[i] = { c[0], c[1], c[2], c[3], c[4] };
+  };
+
+  if( resolution == fullResolution )
+  {
+    //the parameters are quantized to 1 Hz, anything else (e.g. an unsnapped host value) is designed directly
+    const int point = int(freq - minFreq);
+    if( float(point) != freq - minFreq || point < 0 || point >= numPoints )
+      return false;
+
+    auto* c = getBiquads(bandIndex, point, slope);
+    for( int i = 0; i < numBiquads; ++i )
+      set(i, c + i * n);
+
+    return true;
+  }
+
+  //reduced resolution: interpolate linearly between the two neighbouring points on the log frequency axis
+  //(a1, a2 of both neighbours lie in the convex stability triangle, so the interpolated biquads are stable too)
+  const float position = juce::mapFromLog10(juce::jlimit(minFreq, maxFreq, freq), minFreq, maxFreq) * float(resolution - 1);
+  const int point = juce::jmin(int(position), resolution - 2);
+  const float t = position - float(point);
+  if( point + 1 >= numPoints )
+    return false;
+
+  auto* lower = getBiquads(bandIndex, point, slope);
+  auto* upper = getBiquads(bandIndex, point + 1, slope);
+  for( int i = 0; i < numBiquads; ++i )
+  {
+    float c[n];
+    for( int j = 0; j < n; ++j )
+      c[j] = juce::jmap(t, lower[i * n + j], upper[i * n + j]);
+    set(i, c);
+  }
+
+  return true;
+}
+
+juce::String CutFilterTables::Table::getReport() const
+{
+  juce::String report;
+  report << sampleRate << " Hz, "
+         << (resolution == fullResolution ? juce::String("1 Hz steps") : juce::String(resolution) + " points")
+         << ": " << int(getMemoryUsage() / 1024) << " kB, ";
+
+  if( ready.load() )
+    report << "built in " << juce::String(buildTimeMs, 1) << " ms";
+  else
+    report << (cancelled.load() ? "cancelled" : "building");
+
+  return report;
+}
+
+//==============================================================================
+CutFilterTables::CutFilterTables() = default;
+
+CutFilterTables::~CutFilterTables()
+{
+  for( auto* table : tables )
+    table->cancelled = true;
+  //wait for a running build before the tables go away
+  builder.reset();
+}
+
+CutFilterTables::Table::Ptr CutFilterTables::prepare(double sampleRate, int resolution)
+{
+  const juce::ScopedLock sl(lock);
+
+  auto matches = [sampleRate, resolution](const Table& table)
+  {
+    return table.sampleRate == sampleRate && table.resolution == resolution;
+  };
+
+  //tables no instance holds anymore aren't kept around (a full resolution table is several MB),
+  //besides the list a table is only held by the instances and, until it's built, by its build job
+  for( int i = tables.size(); --i >= 0; )
+  {
+    auto* table = tables.getUnchecked(i);
+    if( ! matches(*table) && table->getReferenceCount() == (table->ready.load() ? 1 : 2) )
+    {
+      table->cancelled = true;
+      tables.remove(i);
+    }
+  }
+
+  for( auto* table : tables )
+    if( matches(*table) )
+      return table;
+
+  Table::Ptr table = new Table(sampleRate, resolution);
+  tables.add(table.get());
+
+  if( builder == nullptr )
+    builder = std::make_unique<juce::ThreadPool>(1);
+
+  //the job holds on to its table until the build is done (or cancelled)
+  builder->addJob([table] { table->build(); });
+
+  return table;
+}
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    CoefficientTables.h
+    Created: 18 Oct 2026
+
+    Precomputed low cut / high cut coefficients for every frequency and slope
+    the parameters can take, built on a background thread. While a table
+    isn't ready, lookups fail and the caller designs the filter directly.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+#include "DspKernels.h"
+#include "EQEngine.h"
+
+class CutFilterTables
+{
+public:
+  //resolution of 0 means one entry per Hz (exact, the parameters are quantized to 1 Hz),
+  //anything else is the number of log spaced points between which the coefficients are interpolated
+  static constexpr int fullResolution = 0;
+
+  //coefficients of one sample rate and resolution, immutable once built, so lookups need no lock
+  class Table : public juce::ReferenceCountedObject
+  {
+  public:
+    using Ptr = juce::ReferenceCountedObjectPtr<Table>;
+
+    Table(double sampleRate, int resolution);
+
+    //copy the slope + 1 sections of the cut filter into sections (no locks, no allocations),
+    //returns false if the table isn't ready (or doesn't cover freq)
+    bool lookup(ChainPositions band, float freq, Slope slope, DspKernels::Biquad* sections) const;
+
+    //memory use and build time
+    juce::String getReport() const;
+
+  private:
+    friend class CutFilterTables;
+
+    //every slope needs slope + 1 biquads, so one point holds 1 + 2 + 3 + 4 biquads of 5 coefficients each
+    static constexpr int biquadsPerPoint = 10;
+    static constexpr int coefficientsPerBiquad = 5;
+
+    float getFrequency(int point) const;
+    static size_t getOffset(int point, Slope slope);
+    const float* getBiquads(int bandIndex, int point, Slope slope) const;
+    size_t getMemoryUsage() const;
+
+    void build();
+
+    const double sampleRate;
+    const int resolution;
+    int numPoints = 0;
+    //low cut and high cut coefficients
+    std::vector<float> data[2];
+    double buildTimeMs = 0.0;
+    std::atomic<bool> ready{false}, cancelled{false};
+  };
+
+  CutFilterTables();
+  ~CutFilterTables();
+
+  //the table for this sample rate and resolution, built in the background if it's new
+  //there's one table per rate and resolution in use, instances at different rates each keep theirs,
+  //a table no instance holds anymore is dropped (and stops building) with the next prepare
+  Table::Ptr prepare(double sampleRate, int resolution);
+
+private:
+  juce::ReferenceCountedArray<Table> tables;
+  juce::CriticalSection lock;
+  //one background thread, only created once the mode is used
+  std::unique_ptr<juce::ThreadPool> builder;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CutFilterTables)
+};
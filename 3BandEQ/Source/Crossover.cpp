@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    Crossover.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "Crossover.h"
+
+namespace
+{
+  enum Lane
+  {
+    LowLane,
+    MidLane,
+    HighLane
+  };
+
+  enum Response
+  {
+    LowPass,
+    HighPass,
+    AllPass
+  };
+
+  //b0 b1 b2 a1 a2 (a0 = 1)
+  struct Section
+  {
+    float c[5];
+  };
+
+  //bilinear transform of a second order section, prewarped to the frequency
+  //all three responses share the denominator, that's what makes the allpass line up with the crossover
+  Section design(Response response, double sampleRate, double frequency, double q)
+  {
+    const double k = std::tan(juce::MathConstants<double>::pi * juce::jmin(frequency, 0.49 * sampleRate) / sampleRate);
+    const double norm = 1.0 / (1.0 + k / q + k * k);
+    const double a1 = 2.0 * (k * k - 1.0) * norm;
+    const double a2 = (1.0 - k / q + k * k) * norm;
+
+    switch( response )
+    {
+        case LowPass: return { { float(k * k * norm), float(2.0 * k * k * norm), float(k * k * norm), float(a1), float(a2) } };
+        case HighPass: return { { float(norm), float(-2.0 * norm), float(norm), float(a1), float(a2) } };
+        case AllPass:
+        default: return { { float(a2), float(a1), 1.f, float(a1), float(a2) } };
+    }
+  }
+
+  //Q of the sections of a 12 and a 24 dB/Oct Butterworth filter
+  const double butterworth12[] = { 0.70710678118654752 };
+  const double butterworth24[] = { 0.54119610014619698, 1.30656296487637653 };
+}
+
+Crossover::Crossover()
+{
+    reset();
+}
+
+void Crossover::setCrossovers(double sampleRate, float lowFrequency, Alignment lowAlignment,
+                              float highFrequency, Alignment highAlignment)
+{
+    Section sections[3][maxSections];
+    int count[3] = {};
+
+    auto add = [&](int lane, Response response, double frequency, const double* qs, int numQs)
+    {
+        for( int i = 0; i < numQs; ++i )
+            sections[lane][count[lane]++] = design(response, sampleRate, frequency, qs[i]);
+    };
+
+    //a LR filter is its Butterworth filter twice, the LR sum LP^2 + HP^2 is the allpass of the Butterworth sections
+    auto addCrossover = [&](int lane, Response response, double frequency, Alignment alignment)
+    {
+        const auto* qs = alignment == LinkwitzRiley24 ? butterworth12 : butterworth24;
+        const int numQs = alignment == LinkwitzRiley24 ? 1 : 2;
+        if( response == AllPass )
+        {
+            add(lane, AllPass, frequency, qs, numQs);
+        }
+        else
+        {
+            add(lane, response, frequency, qs, numQs);
+            add(lane, response, frequency, qs, numQs);
+        }
+    };
+
+    //low = AP2 LP1, mid = LP2 HP1, high = HP2 HP1, sum = AP2 (LP1 + HP1) = AP2 AP1
+    addCrossover(LowLane, LowPass, lowFrequency, lowAlignment);
+    addCrossover(LowLane, AllPass, highFrequency, highAlignment);
+    addCrossover(MidLane, HighPass, lowFrequency, lowAlignment);
+    addCrossover(MidLane, LowPass, highFrequency, highAlignment);
+    addCrossover(HighLane, HighPass, lowFrequency, lowAlignment);
+    addCrossover(HighLane, HighPass, highFrequency, highAlignment);
+
+    //the low lane has fewer sections, it passes through the rest
+    const int newNumSections = juce::jmax(count[LowLane], count[MidLane], count[HighLane]);
+
+    //a different number of sections is a different structure, the old state doesn't belong to it
+    if( newNumSections != numSections )
+        reset();
+    numSections = newNumSections;
+
+    const Section passThrough = { { 1.f, 0.f, 0.f, 0.f, 0.f } };
+    for( int i = 0; i < numSections; ++i )
+    {
+        //unused lanes get zero coefficients, so they always output 0
+        b0[i] = b1[i] = b2[i] = minusA1[i] = minusA2[i] = Lanes::expand(0.f);
+
+        for( int lane = 0; lane < 3; ++lane )
+        {
+            const auto& c = (i < count[lane] ? sections[lane][i] : passThrough).c;
+            b0[i].set(size_t(lane), c[0]);
+            b1[i].set(size_t(lane), c[1]);
+            b2[i].set(size_t(lane), c[2]);
+            minusA1[i].set(size_t(lane), -c[3]);
+            minusA2[i].set(size_t(lane), -c[4]);
+        }
+    }
+}
+
+void Crossover::reset()
+{
+    for( int i = 0; i < maxSections; ++i )
+        s1[i] = s2[i] = Lanes::expand(0.f);
+}
+
+void Crossover::process(const float* input, float* low, float* mid, float* high, int numSamples)
+{
+    for( int i = 0; i < numSamples; ++i )
+    {
+        //every lane gets the input and runs its own cascade, the sections of one depth run side by side
+        auto x = Lanes::expand(input[i]);
+
+        for( int j = 0; j < numSections; ++j )
+        {
+            const auto y = b0[j] * x + s1[j];
+            s1[j] = b1[j] * x + minusA1[j] * y + s2[j];
+            s2[j] = b2[j] * x + minusA2[j] * y;
+            x = y;
+        }
+
+        if( low != nullptr )
+            low[i] = x.get(LowLane);
+        if( mid != nullptr )
+            mid[i] = x.get(MidLane);
+        if( high != nullptr )
+            high[i] = x.get(HighLane);
+    }
+
+    //same as juce::dsp::IIR::Filter, keep denormals out of the state
+    for( int j = 0; j < numSections; ++j )
+    {
+        for( size_t lane = 0; lane < Lanes::SIMDNumElements; ++lane )
+        {
+            auto v1 = s1[j].get(lane), v2 = s2[j].get(lane);
+            juce::dsp::util::snapToZero(v1);
+            juce::dsp::util::snapToZero(v2);
+            s1[j].set(lane, v1);
+            s2[j].set(lane, v2);
+        }
+    }
+}
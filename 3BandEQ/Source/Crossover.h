@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    Crossover.h
+    Created: 18 Oct 2026
+
+    Three-way Linkwitz-Riley crossover of one channel. The low band is
+    LP1 followed by the allpass of the upper crossover, the mid band is
+    HP1 followed by LP2 and the high band HP1 followed by HP2, so the
+    three bands always sum to AP1 * AP2 (flat magnitude). A LR crossover
+    is a Butterworth filter run twice, and the allpass that aligns the
+    low band has the same poles, so all of it is designed from the same
+    Butterworth sections. Each band runs in its own SIMD lane, all three
+    in one pass over the block.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+
+class Crossover
+{
+public:
+  //24 dB/Oct (Butterworth 12 dB/Oct run twice) or 48 dB/Oct
+  enum Alignment
+  {
+    LinkwitzRiley24,
+    LinkwitzRiley48
+  };
+
+  //cut slopes of 12 and 24 dB/Oct split at 24 dB/Oct, the steeper ones at 48 dB/Oct
+  static Alignment getAlignment(Slope slope) { return slope <= Slope_24 ? LinkwitzRiley24 : LinkwitzRiley48; }
+
+  Crossover();
+
+  //design both crossover points (no allocations, can be called from the audio thread)
+  //the state is kept unless the number of sections changes
+  void setCrossovers(double sampleRate, float lowFrequency, Alignment lowAlignment,
+                     float highFrequency, Alignment highAlignment);
+
+  void reset();
+
+  //split one channel into its bands, band pointers may be nullptr when nobody listens to that band
+  //(input and low may be the same buffer)
+  void process(const float* input, float* low, float* mid, float* high, int numSamples);
+
+private:
+  using Lanes = juce::dsp::SIMDRegister<float>;
+  static_assert(Lanes::SIMDNumElements >= 3, "the three bands need a lane each");
+
+  //sections of the two 48 dB/Oct crossovers (4 + 4 in the mid and high lanes)
+  static constexpr int maxSections = 8;
+
+  //the feedback coefficients are stored negated so the recursion only needs multiply-adds
+  Lanes b0[maxSections], b1[maxSections], b2[maxSections], minusA1[maxSections], minusA2[maxSections];
+  Lanes s1[maxSections], s2[maxSections];
+  int numSections = 0;
+};
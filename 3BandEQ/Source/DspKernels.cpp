@@ -0,0 +1,189 @@
+/*
+  ==============================================================================
+
+    DspKernels.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "DspKernels.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+ #define EQ_KERNELS_X86 1
+#else
+ #define EQ_KERNELS_X86 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+ #define EQ_KERNELS_VECTOR_EXTENSIONS 1
+#else
+ #define EQ_KERNELS_VECTOR_EXTENSIONS 0
+#endif
+
+namespace DspKernels
+{
+  //same as juce::dsp::util::snapToZero, keeps denormals out of the filter state
+  static inline float snapToZero(float x)
+  {
+    return (x < -1.0e-8f || x > 1.0e-8f) ? x : 0.f;
+  }
+
+#if EQ_KERNELS_VECTOR_EXTENSIONS
+  //one element per lane, the compiler maps it to the widest registers of the target (one AVX, two SSE registers)
+  typedef float LaneVector __attribute__((vector_size(laneWidth * sizeof(float))));
+#endif
+
+  //stage by stage, every sample waits for the one before, so there's nothing for a wider target to vectorize.
+  //"EQTool kernels" measured the avx2 build of this loop about 35% slower than the generic one
+  //(fused multiply-adds lengthen the recursion), so every variant uses this one
+  static void processStages(float* data, int numSamples, const Biquad* stages, float (*state)[2], int numStages)
+  {
+    for( int n = 0; n < numStages; ++n )
+    {
+      const Biquad c = stages[n];
+      float s1 = state[n][0], s2 = state[n][1];
+
+      for( int i = 0; i < numSamples; ++i )
+      {
+        const float x = data[i];
+        const float y = c.b0 * x + s1;
+        s1 = c.b1 * x - c.a1 * y + s2;
+        s2 = c.b2 * x - c.a2 * y;
+        data[i] = y;
+      }
+
+      state[n][0] = snapToZero(s1);
+      state[n][1] = snapToZero(s2);
+    }
+  }
+}
+
+//every variant is the same source compiled with a different target,
+//the compiler is free to use that instruction set (wider vectors, fused multiply-add) inside.
+//measured with "EQTool kernels": avx2 wins the fused, magnitude and lane kernels, an avx512 build gained nothing
+//over it (the lanes are one 256 bit register wide) and ran the fused cascade slower, and an sse2 build is the
+//generic one on x86-64, so those two aren't built
+namespace DspKernels
+{
+#if EQ_KERNELS_X86
+ #define EQ_KERNEL_NAMESPACE avx2
+ #define EQ_KERNEL_NAME "avx2"
+ #define EQ_KERNEL_TARGET __attribute__((target("avx2,fma")))
+ #include "DspKernelsImpl.h"
+#endif
+
+ //whatever the build targets, always available
+ #define EQ_KERNEL_NAMESPACE generic
+ #define EQ_KERNEL_NAME "generic"
+ #define EQ_KERNEL_TARGET
+ #include "DspKernelsImpl.h"
+
+  static bool isSupported(const KernelTable& kernels)
+  {
+#if EQ_KERNELS_X86
+    __builtin_cpu_init();
+
+    if( &kernels == &avx2::table )
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    return &kernels == &generic::table;
+  }
+
+  //fastest first
+  static const KernelTable* const variants[] =
+  {
+#if EQ_KERNELS_X86
+    &avx2::table,
+#endif
+    &generic::table
+  };
+
+  static const KernelTable* findVariant(const char* name)
+  {
+    for( auto* kernels : variants )
+      if( std::strcmp(kernels->name, name) == 0 && isSupported(*kernels) )
+        return kernels;
+
+    return nullptr;
+  }
+
+  static const KernelTable* pickVariant()
+  {
+    if( auto* name = std::getenv("EQ_KERNEL_ISA") )
+      if( auto* kernels = findVariant(name) )
+        return kernels;
+
+    for( auto* kernels : variants )
+      if( isSupported(*kernels) )
+        return kernels;
+
+    return &generic::table;
+  }
+
+  //picked once when the binary is loaded, the kernels are called through this pointer afterwards
+  static std::atomic<const KernelTable*> active { pickVariant() };
+
+  const KernelTable& get()
+  {
+    return *active.load(std::memory_order_relaxed);
+  }
+
+  void processCascade(Execution execution, float* data, int numSamples, const Biquad* stages, float (*state)[2], int numStages)
+  {
+    auto& kernels = get();
+
+    if( execution == Execution::Automatic )
+      execution = numSamples < fusedMinimumLength ? Execution::Stages : Execution::Fused;
+
+    switch( execution )
+    {
+      case Execution::Stages:
+        kernels.processCascade(data, numSamples, stages, state, numStages);
+        break;
+      case Execution::Tiled:
+        for( int start = 0; start < numSamples; start += tileSize )
+          kernels.processCascade(data + start, numSamples - start < tileSize ? numSamples - start : tileSize,
+                                 stages, state, numStages);
+        break;
+      case Execution::Fused:
+      default:
+        kernels.processCascadeFused(data, numSamples, stages, state, numStages);
+        break;
+    }
+  }
+
+  const char* getActiveVariantName()
+  {
+    return get().name;
+  }
+
+  bool forceVariant(const char* name)
+  {
+    if( auto* kernels = findVariant(name) )
+    {
+      active.store(kernels, std::memory_order_relaxed);
+      return true;
+    }
+
+    return false;
+  }
+
+  int getNumVariants()
+  {
+    return int(sizeof(variants) / sizeof(variants[0]));
+  }
+
+  const KernelTable* getVariant(int index)
+  {
+    if( index < 0 || index >= getNumVariants() || ! isSupported(*variants[index]) )
+      return nullptr;
+
+    return variants[index];
+  }
+}
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    DspKernels.h
+    Created: 18 Oct 2026
+
+    The hot DSP loops, compiled for several instruction sets into the same
+    binary. The best variant the CPU supports is picked once when the
+    binary is loaded, so one build runs at full speed on old and new
+    machines alike. Setting the environment variable EQ_KERNEL_ISA to
+    "generic" or "avx2" overrides the choice for testing.
+
+    Only kernels that gain from a wider target get a variant per instruction
+    set, measured with "EQTool kernels" (see DspKernels.cpp).
+
+    Plain C++ without JUCE, so it can be used outside of the plugin.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+namespace DspKernels
+{
+  //normalised biquad coefficients (a0 = 1), same order as juce::dsp::IIR::Coefficients::getRawCoefficients()
+  struct Biquad
+  {
+    float b0{1}, b1{0}, b2{0}, a1{0}, a2{0};
+  };
+
+  //independent signals processed side by side (one AVX register, two SSE registers)
+  constexpr int laneWidth = 8;
+
+  //biquad with its own coefficients in every lane
+  struct alignas(32) LaneBiquad
+  {
+    float b0[laneWidth], b1[laneWidth], b2[laneWidth], a1[laneWidth], a2[laneWidth];
+  };
+
+  //s1 and s2 of one stage in every lane
+  struct alignas(32) LaneState
+  {
+    float s1[laneWidth], s2[laneWidth];
+  };
+
+  struct KernelTable
+  {
+    //name of the variant
+    const char* name;
+
+    //run the data through numStages biquads one after another (transposed direct form II),
+    //state holds s1 and s2 of every stage
+    void (*processCascade)(float* data, int numSamples, const Biquad* stages, float (*state)[2], int numStages);
+
+    //same result, but every sample runs through all stages before the next one (states stay in registers)
+    void (*processCascadeFused)(float* data, int numSamples, const Biquad* stages, float (*state)[2], int numStages);
+
+    //multiply squaredMagnitudes[i] by the squared magnitude of the biquad at the normalised angular frequency w[i],
+    //given as cos(w[i]) and cos(2 w[i])
+    void (*multiplySquaredMagnitudes)(const Biquad& biquad, const double* cosW, const double* cos2W,
+                                      double* squaredMagnitudes, int num);
+
+    //run laneWidth signals through their own cascades of numStages biquads, every sample through all stages,
+    //data is interleaved (sample i of lane l at data[i * laneWidth + l])
+    void (*processLanes)(float* data, int numSamples, const LaneBiquad* stages, LaneState* state, int numStages);
+  };
+
+  //the variant in use
+  const KernelTable& get();
+
+  //how a cascade walks over a block
+  enum class Execution
+  {
+    //every stage makes its own pass over the whole block
+    Stages,
+    //the block is split into tiles that stay in L1, every stage runs over one tile before the next tile
+    Tiled,
+    //every sample runs through all stages at once
+    Fused,
+    //picked per block from its length
+    Automatic
+  };
+
+  //samples per tile (4 kB, leaves L1 room for everything else)
+  constexpr int tileSize = 1024;
+  //Automatic runs shorter blocks stage by stage and longer ones fused
+  //(crossover measured with "EQTool bench", fused wins from 16 to 32 samples up on current x86 cores)
+  constexpr int fusedMinimumLength = 32;
+
+  //run a cascade with the variant in use and the chosen execution
+  void processCascade(Execution execution, float* data, int numSamples, const Biquad* stages, float (*state)[2], int numStages);
+
+  //name of the variant in use
+  const char* getActiveVariantName();
+
+  //use a specific variant (for testing), returns false if it isn't available on this CPU or build
+  bool forceVariant(const char* name);
+
+  //number of variants in this build, and variant i of them (nullptr if this CPU can't run it)
+  int getNumVariants();
+  const KernelTable* getVariant(int index);
+}
@@ -0,0 +1,234 @@
+/*
+  ==============================================================================
+
+    DspKernelsImpl.h
+    Created: 18 Oct 2026
+
+    Kernel bodies, included by DspKernels.cpp once per instruction set with
+    EQ_KERNEL_NAMESPACE, EQ_KERNEL_NAME and EQ_KERNEL_TARGET defined.
+    No include guard on purpose.
+
+  ==============================================================================
+*/
+
+namespace EQ_KERNEL_NAMESPACE
+{
+  //all stages per sample, with N known at compile time the coefficients and states stay in registers
+  //and the recursions of neighbouring stages overlap in the pipeline
+  template<int N>
+  EQ_KERNEL_TARGET
+  static void processFused(float* data, int numSamples, const Biquad* stages, float (*state)[2])
+  {
+    float b0[N], b1[N], b2[N], a1[N], a2[N], s1[N], s2[N];
+    for( int n = 0; n < N; ++n )
+    {
+      b0[n] = stages[n].b0; b1[n] = stages[n].b1; b2[n] = stages[n].b2;
+      a1[n] = stages[n].a1; a2[n] = stages[n].a2;
+      s1[n] = state[n][0]; s2[n] = state[n][1];
+    }
+
+    for( int i = 0; i < numSamples; ++i )
+    {
+      float x = data[i];
+      for( int n = 0; n < N; ++n )
+      {
+        const float y = b0[n] * x + s1[n];
+        s1[n] = b1[n] * x - a1[n] * y + s2[n];
+        s2[n] = b2[n] * x - a2[n] * y;
+        x = y;
+      }
+      data[i] = x;
+    }
+
+    for( int n = 0; n < N; ++n )
+    {
+      state[n][0] = snapToZero(s1[n]);
+      state[n][1] = snapToZero(s2[n]);
+    }
+  }
+
+  EQ_KERNEL_TARGET
+  static void processCascadeFused(float* data, int numSamples, const Biquad* stages, float (*state)[2], int numStages)
+  {
+    switch( numStages )
+    {
+      case 0: break;
+      case 1: processFused<1>(data, numSamples, stages, state); break;
+      case 2: processFused<2>(data, numSamples, stages, state); break;
+      case 3: processFused<3>(data, numSamples, stages, state); break;
+      case 4: processFused<4>(data, numSamples, stages, state); break;
+      case 5: processFused<5>(data, numSamples, stages, state); break;
+      case 6: processFused<6>(data, numSamples, stages, state); break;
+      case 7: processFused<7>(data, numSamples, stages, state); break;
+      case 8: processFused<8>(data, numSamples, stages, state); break;
+      case 9: processFused<9>(data, numSamples, stages, state); break;
+      //longer cascades in fused groups of up to 9
+      default:
+        for( int first = 0; first < numStages; first += 9 )
+          processCascadeFused(data, numSamples, stages + first, state + first, numStages - first < 9 ? numStages - first : 9);
+        break;
+    }
+  }
+
+  EQ_KERNEL_TARGET
+  static void multiplySquaredMagnitudes(const Biquad& c, const double* cosW, const double* cos2W,
+                                        double* squaredMagnitudes, int num)
+  {
+    //|b0 + b1 e^-jw + b2 e^-2jw|^2 = b0^2 + b1^2 + b2^2 + 2 (b0 b1 + b1 b2) cos(w) + 2 b0 b2 cos(2w), same for a
+    const double b0 = c.b0, b1 = c.b1, b2 = c.b2, a1 = c.a1, a2 = c.a2;
+    const double n0 = b0 * b0 + b1 * b1 + b2 * b2, n1 = 2.0 * (b0 * b1 + b1 * b2), n2 = 2.0 * b0 * b2;
+    const double d0 = 1.0 + a1 * a1 + a2 * a2, d1 = 2.0 * (a1 + a1 * a2), d2 = 2.0 * a2;
+
+    //no dependency between the frequencies, so this loop vectorizes to the width of the target
+    for( int i = 0; i < num; ++i )
+      squaredMagnitudes[i] *= (n0 + n1 * cosW[i] + n2 * cos2W[i]) / (d0 + d1 * cosW[i] + d2 * cos2W[i]);
+  }
+
+#if EQ_KERNELS_VECTOR_EXTENSIONS
+  //one stage in all lanes
+  EQ_KERNEL_TARGET __attribute__((always_inline))
+  static inline void processLaneStage(LaneVector& x, const LaneVector (&c)[5], LaneVector& s1, LaneVector& s2)
+  {
+    const LaneVector y = c[0] * x + s1;
+    s1 = c[1] * x - c[3] * y + s2;
+    s2 = c[2] * x - c[4] * y;
+    x = y;
+  }
+
+  //the lanes are independent, so every step of the recursion is one vector operation over all of them.
+  //written with vector types and the stages unrolled by the fold, the auto-vectorizer only managed this at -O3
+  template<int... n>
+  EQ_KERNEL_TARGET
+  static void processLanesUnrolled(std::integer_sequence<int, n...>, float* data, int numSamples,
+                                   const LaneBiquad* stages, LaneState* state)
+  {
+    constexpr int N = int(sizeof...(n));
+    LaneVector c[N][5], s1[N], s2[N];
+    for( int k = 0; k < N; ++k )
+    {
+      std::memcpy(&c[k][0], stages[k].b0, sizeof(LaneVector));
+      std::memcpy(&c[k][1], stages[k].b1, sizeof(LaneVector));
+      std::memcpy(&c[k][2], stages[k].b2, sizeof(LaneVector));
+      std::memcpy(&c[k][3], stages[k].a1, sizeof(LaneVector));
+      std::memcpy(&c[k][4], stages[k].a2, sizeof(LaneVector));
+      std::memcpy(&s1[k], state[k].s1, sizeof(LaneVector));
+      std::memcpy(&s2[k], state[k].s2, sizeof(LaneVector));
+    }
+
+    for( int i = 0; i < numSamples; ++i )
+    {
+      LaneVector x;
+      std::memcpy(&x, data + i * laneWidth, sizeof(LaneVector));
+      (processLaneStage(x, c[n], s1[n], s2[n]), ...);
+      std::memcpy(data + i * laneWidth, &x, sizeof(LaneVector));
+    }
+
+    for( int k = 0; k < N; ++k )
+    {
+      for( int l = 0; l < laneWidth; ++l )
+      {
+        state[k].s1[l] = snapToZero(s1[k][l]);
+        state[k].s2[l] = snapToZero(s2[k][l]);
+      }
+    }
+  }
+
+  template<int N>
+  EQ_KERNEL_TARGET
+  static void processLanesFused(float* data, int numSamples, const LaneBiquad* stages, LaneState* state)
+  {
+    processLanesUnrolled(std::make_integer_sequence<int, N>(), data, numSamples, stages, state);
+  }
+#else
+  //the lanes are independent, so every step of the recursion is one vector operation over all of them
+  //(with compilers that vectorize the lane loop, most do only at their highest optimisation level)
+  template<int N>
+  EQ_KERNEL_TARGET
+  static void processLanesFused(float* data, int numSamples, const LaneBiquad* stages, LaneState* state)
+  {
+    float s1[N][laneWidth], s2[N][laneWidth];
+    for( int n = 0; n < N; ++n )
+    {
+      for( int l = 0; l < laneWidth; ++l )
+      {
+        s1[n][l] = state[n].s1[l];
+        s2[n][l] = state[n].s2[l];
+      }
+    }
+
+    //local copies, so the compiler knows nothing aliases the data and keeps it all in registers
+    LaneBiquad c[N];
+    for( int n = 0; n < N; ++n )
+      c[n] = stages[n];
+
+    for( int i = 0; i < numSamples; ++i )
+    {
+      float x[laneWidth];
+      for( int l = 0; l < laneWidth; ++l )
+        x[l] = data[i * laneWidth + l];
+
+      //written per lane with the stages inside, that's the loop the compiler turns into vector operations across the lanes
+      for( int l = 0; l < laneWidth; ++l )
+      {
+        float v = x[l];
+        for( int n = 0; n < N; ++n )
+        {
+          const float y = c[n].b0[l] * v + s1[n][l];
+          s1[n][l] = c[n].b1[l] * v - c[n].a1[l] * y + s2[n][l];
+          s2[n][l] = c[n].b2[l] * v - c[n].a2[l] * y;
+          v = y;
+        }
+        x[l] = v;
+      }
+
+      for( int l = 0; l < laneWidth; ++l )
+        data[i * laneWidth + l] = x[l];
+    }
+
+    for( int n = 0; n < N; ++n )
+    {
+      for( int l = 0; l < laneWidth; ++l )
+      {
+        state[n].s1[l] = snapToZero(s1[n][l]);
+        state[n].s2[l] = snapToZero(s2[n][l]);
+      }
+    }
+  }
+#endif
+
+  EQ_KERNEL_TARGET
+  static void processLanes(float* data, int numSamples, const LaneBiquad* stages, LaneState* state, int numStages)
+  {
+    switch( numStages )
+    {
+      case 0: break;
+      case 1: processLanesFused<1>(data, numSamples, stages, state); break;
+      case 2: processLanesFused<2>(data, numSamples, stages, state); break;
+      case 3: processLanesFused<3>(data, numSamples, stages, state); break;
+      case 4: processLanesFused<4>(data, numSamples, stages, state); break;
+      case 5: processLanesFused<5>(data, numSamples, stages, state); break;
+      case 6: processLanesFused<6>(data, numSamples, stages, state); break;
+      case 7: processLanesFused<7>(data, numSamples, stages, state); break;
+      case 8: processLanesFused<8>(data, numSamples, stages, state); break;
+      case 9: processLanesFused<9>(data, numSamples, stages, state); break;
+      //longer cascades in fused groups of up to 9
+      default:
+        for( int first = 0; first < numStages; first += 9 )
+          processLanes(data, numSamples, stages + first, state + first, numStages - first < 9 ? numStages - first : 9);
+        break;
+    }
+  }
+
+  static const KernelTable table
+  {
+    EQ_KERNEL_NAME,
+    processStages,
+    processCascadeFused,
+    multiplySquaredMagnitudes,
+    processLanes
+  };
+}
+
+#undef EQ_KERNEL_NAMESPACE
+#undef EQ_KERNEL_NAME
+#undef EQ_KERNEL_TARGET
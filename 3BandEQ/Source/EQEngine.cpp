@@ -0,0 +1,274 @@
+/*
+  ==============================================================================
+
+    EQEngine.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "EQEngine.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  constexpr double pi = 3.14159265358979323846;
+
+  //bilinear transform of a Butterworth section, prewarped to the cut frequency
+  DspKernels::Biquad designCutSection(bool highPass, double sampleRate, double frequency, double q)
+  {
+    //above Nyquist (e.g. the 20 kHz default at 16 kHz) the filter sits just below it
+    const double k = std::tan(pi * std::min(frequency, 0.49 * sampleRate) / sampleRate);
+    const double norm = 1.0 / (1.0 + k / q + k * k);
+    const double a1 = 2.0 * (k * k - 1.0) * norm, a2 = (1.0 - k / q + k * k) * norm;
+
+    if( highPass )
+      return { float(norm), float(-2.0 * norm), float(norm), float(a1), float(a2) };
+
+    return { float(k * k * norm), float(2.0 * k * k * norm), float(k * k * norm), float(a1), float(a2) };
+  }
+
+  //same as juce::dsp::IIR::Coefficients::makePeakFilter
+  DspKernels::Biquad designPeakFilter(double sampleRate, double frequency, double q, double gainInDecibels)
+  {
+    const double a = std::sqrt(std::pow(10.0, gainInDecibels / 20.0));
+    const double omega = 2.0 * pi * std::min(frequency, 0.49 * sampleRate) / sampleRate;
+    const double alpha = std::sin(omega) / (2.0 * q);
+    const double c2 = -2.0 * std::cos(omega);
+    const double a0 = 1.0 + alpha / a;
+
+    return { float((1.0 + alpha * a) / a0), float(c2 / a0), float((1.0 - alpha * a) / a0),
+             float(c2 / a0), float((1.0 - alpha / a) / a0) };
+  }
+
+  void setLane(DspKernels::LaneBiquad& stage, int lane, const DspKernels::Biquad& biquad)
+  {
+    stage.b0[lane] = biquad.b0;
+    stage.b1[lane] = biquad.b1;
+    stage.b2[lane] = biquad.b2;
+    stage.a1[lane] = biquad.a1;
+    stage.a2[lane] = biquad.a2;
+  }
+}
+
+EQEngine::EQEngine(double newSampleRate, int newMaxBlockSize, const std::vector<int>& newChannelsPerStream)
+    : sampleRate(newSampleRate), maxBlockSize(std::max(1, newMaxBlockSize)), channelsPerStream(newChannelsPerStream)
+{
+    //lanes are handed out in stream order, a stream never straddles two batches (mid and side are coded together)
+    for( std::size_t s = 0; s < channelsPerStream.size(); ++s )
+    {
+        const int used = int(lanes.size()) % laneWidth;
+        if( used > 0 && used + channelsPerStream[s] > laneWidth )
+            lanes.resize(lanes.size() + std::size_t(laneWidth - used));
+
+        firstLane.push_back(int(lanes.size()));
+        for( int ch = 0; ch < channelsPerStream[s]; ++ch )
+            lanes.push_back({ int(s), ch });
+    }
+
+    numBatches = int((lanes.size() + laneWidth - 1) / laneWidth);
+    lanes.resize(std::size_t(numBatches * laneWidth));
+    laneLength.assign(lanes.size(), 0);
+    midSide.assign(channelsPerStream.size(), 0);
+    batchLength.assign(std::size_t(numBatches), 0);
+
+    //unused lanes pass through and only ever see silence
+    DspKernels::LaneBiquad passThrough;
+    for( int l = 0; l < laneWidth; ++l )
+        setLane(passThrough, l, DspKernels::Biquad());
+    coefficients.assign(std::size_t(numBatches * maxStages), passThrough);
+    states.assign(std::size_t(numBatches * maxStages), DspKernels::LaneState());
+    scratch.assign(std::size_t(numBatches) * std::size_t(maxBlockSize) * laneWidth, 0.f);
+
+    const auto defaults = getDefaultSettings();
+    for( int s = 0; s < getNumStreams(); ++s )
+        setSettings(s, defaults);
+}
+
+ChainSettings EQEngine::getDefaultSettings()
+{
+    ChainSettings settings;
+    settings.lowCutFreq = 20.f;
+    settings.highCutFreq = 20000.f;
+    settings.peakFreq = 750.f;
+    settings.peakGainInDecibels = 0.f;
+    settings.peakQuality = 1.f;
+    return settings;
+}
+
+int EQEngine::design(const ChainSettings& settings, double sampleRate, DspKernels::Biquad (&stages)[maxStages])
+{
+    for( auto& stage : stages )
+        stage = DspKernels::Biquad();
+
+    stages[0] = designPeak(settings, sampleRate);
+
+    int length = 1;
+    auto addCut = [&](bool lowCut, float frequency, Slope slope, int firstSlot)
+    {
+        DspKernels::Biquad sections[4];
+        const int numSections = designCut(lowCut, frequency, slope, sampleRate, sections);
+        for( int i = 0; i < numSections; ++i )
+            stages[firstSlot + 2 * i] = sections[i];
+        length = std::max(length, firstSlot + 2 * numSections - 1);
+    };
+
+    //low cut sections in the odd slots, high cut sections in the even ones after the peak
+    addCut(true, settings.lowCutFreq, settings.lowCutSlope, 1);
+    addCut(false, settings.highCutFreq, settings.highCutSlope, 2);
+
+    return length;
+}
+
+DspKernels::Biquad EQEngine::designPeak(const ChainSettings& settings, double sampleRate)
+{
+    return designPeakFilter(sampleRate, settings.peakFreq, settings.peakQuality, settings.peakGainInDecibels);
+}
+
+int EQEngine::designCut(bool lowCut, float frequency, Slope slope, double sampleRate, DspKernels::Biquad* sections)
+{
+    //a Butterworth filter of order 2m is m sections with Q = 1 / (2 cos((2i + 1) pi / 4m))
+    //(same as juce::dsp::FilterDesign's high order Butterworth method for even orders)
+    const int numSections = int(slope) + 1;
+    for( int i = 0; i < numSections; ++i )
+    {
+        const double q = 1.0 / (2.0 * std::cos((2.0 * i + 1.0) * pi / (4.0 * numSections)));
+        sections[i] = designCutSection(lowCut, sampleRate, frequency, q);
+    }
+
+    return numSections;
+}
+
+void EQEngine::setSettings(int stream, const ChainSettings& settings)
+{
+    for( int ch = 0; ch < getNumChannels(stream); ++ch )
+        setSettings(stream, ch, settings);
+}
+
+void EQEngine::setSettings(int stream, int channel, const ChainSettings& settings)
+{
+    DspKernels::Biquad stages[maxStages];
+    const int length = design(settings, sampleRate, stages);
+
+    const int lane = firstLane[std::size_t(stream)] + channel;
+    const int batch = lane / laneWidth, l = lane % laneWidth;
+    auto* batchCoefficients = coefficients.data() + batch * maxStages;
+    auto* batchStates = states.data() + batch * maxStages;
+
+    for( int n = 0; n < maxStages; ++n )
+    {
+        setLane(batchCoefficients[n], l, stages[n]);
+
+        //a stage that passes through keeps a zero state, stale state would come back once it filters again
+        if( n >= length )
+            batchStates[n].s1[l] = batchStates[n].s2[l] = 0.f;
+    }
+
+    laneLength[std::size_t(lane)] = length;
+    batchLength[std::size_t(batch)] = *std::max_element(laneLength.begin() + batch * laneWidth,
+                                                        laneLength.begin() + (batch + 1) * laneWidth);
+}
+
+void EQEngine::setMidSide(int stream, bool shouldUseMidSide)
+{
+    if( getNumChannels(stream) != 2 )
+        return;
+
+    //the states belong to the other signals
+    if( bool(midSide[std::size_t(stream)]) != shouldUseMidSide )
+        reset(stream);
+
+    midSide[std::size_t(stream)] = shouldUseMidSide;
+}
+
+void EQEngine::reset()
+{
+    std::fill(states.begin(), states.end(), DspKernels::LaneState());
+}
+
+void EQEngine::reset(int stream)
+{
+    for( int ch = 0; ch < getNumChannels(stream); ++ch )
+    {
+        const int lane = firstLane[std::size_t(stream)] + ch;
+        auto* batchStates = states.data() + (lane / laneWidth) * maxStages;
+        for( int n = 0; n < maxStages; ++n )
+            batchStates[n].s1[lane % laneWidth] = batchStates[n].s2[lane % laneWidth] = 0.f;
+    }
+}
+
+void EQEngine::process(float* const* const* streams, int numSamples)
+{
+    for( int batch = 0; batch < numBatches; ++batch )
+        processBatch(batch, streams, numSamples);
+}
+
+void EQEngine::processBatch(int batch, float* const* const* streams, int numSamples)
+{
+    auto& kernels = DspKernels::get();
+    const auto* batchLanes = lanes.data() + batch * laneWidth;
+    auto* data = scratch.data() + std::size_t(batch) * std::size_t(maxBlockSize) * laneWidth;
+
+    for( int start = 0; start < numSamples; start += maxBlockSize )
+    {
+        const int num = std::min(maxBlockSize, numSamples - start);
+
+        //interleave the lanes of the batch, so every sample of the batch is one vector
+        for( int l = 0; l < laneWidth; ++l )
+        {
+            if( batchLanes[l].stream < 0 )
+                continue;
+
+            auto* const* channels = streams[batchLanes[l].stream];
+
+            //mid and side are encoded while interleaving
+            if( midSide[std::size_t(batchLanes[l].stream)] )
+            {
+                const float* left = channels[0] + start;
+                const float* right = channels[1] + start;
+                const float sign = batchLanes[l].channel == 0 ? 1.f : -1.f;
+                for( int i = 0; i < num; ++i )
+                    data[i * laneWidth + l] = 0.5f * (left[i] + sign * right[i]);
+                continue;
+            }
+
+            const float* source = channels[batchLanes[l].channel] + start;
+            for( int i = 0; i < num; ++i )
+                data[i * laneWidth + l] = source[i];
+        }
+
+        kernels.processLanes(data, num, coefficients.data() + batch * maxStages, states.data() + batch * maxStages,
+                             batchLength[std::size_t(batch)]);
+
+        for( int l = 0; l < laneWidth; ++l )
+        {
+            if( batchLanes[l].stream < 0 )
+                continue;
+
+            auto* const* channels = streams[batchLanes[l].stream];
+
+            //decoded while deinterleaving, both channels are written with the mid lane (the side lane is the next one)
+            if( midSide[std::size_t(batchLanes[l].stream)] )
+            {
+                if( batchLanes[l].channel == 0 )
+                {
+                    float* left = channels[0] + start;
+                    float* right = channels[1] + start;
+                    for( int i = 0; i < num; ++i )
+                    {
+                        const float mid = data[i * laneWidth + l], side = data[i * laneWidth + l + 1];
+                        left[i] = mid + side;
+                        right[i] = mid - side;
+                    }
+                }
+                continue;
+            }
+
+            float* destination = channels[batchLanes[l].channel] + start;
+            for( int i = 0; i < num; ++i )
+                destination[i] = data[i * laneWidth + l];
+        }
+    }
+}
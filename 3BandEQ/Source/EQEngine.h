@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    EQEngine.h
+    Created: 18 Oct 2026
+
+    The 3BandEQ chain for many independent streams at once, e.g. server
+    side on hundreds of mono or stereo streams. Every channel of every
+    stream is a lane; lanes are grouped into batches of
+    DspKernels::laneWidth, and the coefficients and states of a batch sit
+    next to each other in contiguous arrays, so one pass of the lane kernel
+    filters a whole batch in SIMD. Batches don't share anything, so they
+    can be processed from a thread pool.
+
+    Plain C++ without JUCE (no AudioProcessor, no parameters, no GUI).
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "ChainSettings.h"
+#include "DspKernels.h"
+
+class EQEngine
+{
+public:
+  static constexpr int laneWidth = DspKernels::laneWidth;
+
+  //stages of a lane: the peak filter first, then low cut and high cut sections taking turns
+  //(the filters commute), so every lane uses a prefix of the stages that only grows with the slopes
+  static constexpr int maxStages = 9;
+
+  //every entry is one stream with that many channels (usually 1 or 2)
+  //all streams start with the plugin's default settings
+  EQEngine(double sampleRate, int maxBlockSize, const std::vector<int>& channelsPerStream);
+
+  int getNumStreams() const { return int(firstLane.size()); }
+  int getNumChannels(int stream) const { return channelsPerStream[std::size_t(stream)]; }
+  int getNumBatches() const { return numBatches; }
+  double getSampleRate() const { return sampleRate; }
+
+  //redesign the coefficients of all channels of a stream (no allocations)
+  //don't call it while the stream's batch is processed
+  void setSettings(int stream, const ChainSettings& settings);
+  //settings of a single channel of a stream
+  void setSettings(int stream, int channel, const ChainSettings& settings);
+
+  //a stereo stream can be filtered as mid (channel 0) and side (channel 1) instead of left and right,
+  //encoded on the way into the lanes and decoded on the way out, so it costs no extra pass
+  void setMidSide(int stream, bool shouldUseMidSide);
+
+  //designs after this are made for the new rate, set the settings of every channel again
+  //(the states are kept, they're reset separately)
+  void setSampleRate(double newSampleRate) { sampleRate = newSampleRate; }
+
+  void reset();
+  void reset(int stream);
+
+  //filter all streams in place, streams[s][ch] is channel ch of stream s
+  void process(float* const* const* streams, int numSamples);
+  //filter only the lanes of one batch, different batches can run on different threads at the same time
+  void processBatch(int batch, float* const* const* streams, int numSamples);
+
+  //stages of a chain in the engine's order, returns how many of them are in use (the rest pass through)
+  //same filters as the plugin: Butterworth cuts and the RBJ peak filter through the bilinear transform
+  static int design(const ChainSettings& settings, double sampleRate, DspKernels::Biquad (&stages)[maxStages]);
+  //the bands design() is made of, for users that need only one of them
+  static DspKernels::Biquad designPeak(const ChainSettings& settings, double sampleRate);
+  //the slope + 1 sections of the low cut (lowCut) or high cut filter, returns how many
+  static int designCut(bool lowCut, float frequency, Slope slope, double sampleRate, DspKernels::Biquad* sections);
+
+  //the plugin's default settings
+  static ChainSettings getDefaultSettings();
+
+private:
+  //where a lane comes from (stream -1 for the unused lanes at the end of the last batch)
+  struct Lane
+  {
+    int stream = -1, channel = 0;
+  };
+
+  double sampleRate;
+  int maxBlockSize;
+  int numBatches = 0;
+
+  std::vector<int> channelsPerStream, firstLane;
+  std::vector<char> midSide;
+  std::vector<Lane> lanes;
+  //stages in use per lane and per batch (the longest lane of the batch)
+  std::vector<int> laneLength, batchLength;
+
+  //maxStages per batch, batch after batch
+  std::vector<DspKernels::LaneBiquad> coefficients;
+  std::vector<DspKernels::LaneState> states;
+  //interleaved block of every batch, maxBlockSize * laneWidth per batch
+  std::vector<float> scratch;
+};
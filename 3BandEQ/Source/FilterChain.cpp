@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    FilterChain.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "FilterChain.h"
+#include "EQEngine.h"
+
+namespace
+{
+  Coefficients toCoefficients(const DspKernels::Biquad& biquad)
+  {
+    //a0 = 1, so the coefficients are taken over unchanged
+    return new juce::dsp::IIR::Coefficients<float>(biquad.b0, biquad.b1, biquad.b2, 1.f, biquad.a1, biquad.a2);
+  }
+
+  //only the band asked for is designed
+  CutCoefficients makeCutFilter(bool lowCut, float frequency, Slope slope, double sampleRate)
+  {
+    DspKernels::Biquad sections[4];
+    const int numSections = EQEngine::designCut(lowCut, frequency, slope, sampleRate, sections);
+
+    CutCoefficients coefficients;
+    for( int i = 0; i < numSections; ++i )
+      coefficients.add(toCoefficients(sections[i]));
+    return coefficients;
+  }
+}
+
+//free function to make peak filter coefficients
+Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRate)
+{
+    return toCoefficients(EQEngine::designPeak(chainSettings, sampleRate));
+}
+
+CutCoefficients makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate)
+{
+    return makeCutFilter(true, chainSettings.lowCutFreq, chainSettings.lowCutSlope, sampleRate);
+}
+
+CutCoefficients makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate)
+{
+    return makeCutFilter(false, chainSettings.highCutFreq, chainSettings.highCutSlope, sampleRate);
+}
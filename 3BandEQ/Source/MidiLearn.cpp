@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    MidiLearn.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "MidiLearn.h"
+
+const juce::Identifier MidiLearn::stateType("MidiLearn");
+
+namespace
+{
+  const juce::Identifier mappingType("Mapping"), parameterProperty("parameter"), controllerProperty("controller");
+
+  juce::String getParameterID(const juce::AudioProcessorParameter* parameter)
+  {
+    if( auto* withID = dynamic_cast<const juce::AudioProcessorParameterWithID*>(parameter) )
+      return withID->paramID;
+    return {};
+  }
+}
+
+MidiLearn::MidiLearn()
+{
+    clearAll();
+}
+
+void MidiLearn::startLearning(int parameterIndex)
+{
+    learning = parameterIndex;
+}
+
+void MidiLearn::stopLearning()
+{
+    learning = -1;
+}
+
+void MidiLearn::clear(int parameterIndex)
+{
+    for( auto& target : targets )
+    {
+        int expected = parameterIndex;
+        target.compare_exchange_strong(expected, -1);
+    }
+}
+
+void MidiLearn::clearAll()
+{
+    for( auto& target : targets )
+        target = -1;
+}
+
+int MidiLearn::getController(int parameterIndex) const
+{
+    for( int controller = 0; controller < numControllers; ++controller )
+        if( targets[controller].load() == parameterIndex )
+            return controller;
+    return -1;
+}
+
+int MidiLearn::handleController(int controller, bool& mappingChanged)
+{
+    if( controller < 0 || controller >= numControllers )
+        return -1;
+
+    const int armed = learning.exchange(-1);
+    if( armed >= 0 )
+    {
+        //a parameter follows one controller, a controller drives one parameter
+        clear(armed);
+        targets[controller] = armed;
+        mappingChanged = true;
+    }
+
+    return targets[controller].load();
+}
+
+juce::ValueTree MidiLearn::createState(const juce::Array<juce::AudioProcessorParameter*>& parameters) const
+{
+    juce::ValueTree state(stateType);
+
+    for( int controller = 0; controller < numControllers; ++controller )
+    {
+        const int index = targets[controller].load();
+        if( index < 0 || index >= parameters.size() )
+            continue;
+
+        juce::ValueTree mapping(mappingType);
+        mapping.setProperty(parameterProperty, getParameterID(parameters[index]), nullptr);
+        mapping.setProperty(controllerProperty, controller, nullptr);
+        state.appendChild(mapping, nullptr);
+    }
+
+    return state;
+}
+
+void MidiLearn::loadState(const juce::ValueTree& state, const juce::Array<juce::AudioProcessorParameter*>& parameters)
+{
+    clearAll();
+    stopLearning();
+
+    for( const auto& mapping : state )
+    {
+        const auto parameterID = mapping.getProperty(parameterProperty).toString();
+        const int controller = mapping.getProperty(controllerProperty, -1);
+        if( ! mapping.hasType(mappingType) || controller < 0 || controller >= numControllers )
+            continue;
+
+        for( int index = 0; index < parameters.size(); ++index )
+        {
+            if( getParameterID(parameters[index]) == parameterID )
+            {
+                targets[controller] = index;
+                break;
+            }
+        }
+    }
+}
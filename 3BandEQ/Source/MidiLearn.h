@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    MidiLearn.h
+    Created: 18 Oct 2026
+
+    Map of MIDI continuous controllers to parameters. A parameter is armed
+    from the editor, and the next controller that arrives on the audio
+    thread is mapped to it. Lookups and learning are lock-free, the map is
+    stored in the plugin state by parameter ID.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class MidiLearn
+{
+public:
+  static constexpr int numControllers = 128;
+
+  //type of the tree the map is stored in
+  static const juce::Identifier stateType;
+
+  MidiLearn();
+
+  //the next controller that arrives is mapped to this parameter (index in AudioProcessor::getParameters())
+  void startLearning(int parameterIndex);
+  void stopLearning();
+  //parameter that waits for a controller, -1 if none
+  int getLearningParameter() const { return learning.load(); }
+
+  //remove the controller of a parameter, or of all of them
+  void clear(int parameterIndex);
+  void clearAll();
+
+  //controller mapped to a parameter, -1 if there's none
+  int getController(int parameterIndex) const;
+
+  //audio thread: the parameter a controller drives, -1 if it isn't mapped
+  //if a parameter is armed, the controller is mapped to it first and mappingChanged is set
+  int handleController(int controller, bool& mappingChanged);
+
+  //the map as a tree of parameter IDs (message thread)
+  juce::ValueTree createState(const juce::Array<juce::AudioProcessorParameter*>& parameters) const;
+  //controllers of parameters that don't exist (anymore) are dropped
+  void loadState(const juce::ValueTree& state, const juce::Array<juce::AudioProcessorParameter*>& parameters);
+
+private:
+  //parameter index per controller, -1 for the controllers that aren't mapped
+  std::atomic<int> targets[numControllers];
+  std::atomic<int> learning{-1};
+
+  JUCE_DECLARE_NON_COPYABLE (MidiLearn)
+};
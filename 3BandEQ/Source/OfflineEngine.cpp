@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+    OfflineEngine.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "OfflineEngine.h"
+
+//helper function to update one filter of a cut chain (the filter shares the immutable coefficients)
+template<int Index, typename ChainType, typename CoefficientType>
+static void update(ChainType& chain, const CoefficientType& coefficients)
+{
+    chain.template get<Index>().coefficients = coefficients[Index];
+    chain.template setBypassed<Index>(false);
+}
+
+//helper function to update a cut chain, the filters above the slope are bypassed
+template<typename ChainType, typename CoefficientType>
+static void updateCutFilter(ChainType& chain, const CoefficientType& coefficients, Slope slope)
+{
+    chain.template setBypassed<0>(true);
+    chain.template setBypassed<1>(true);
+    chain.template setBypassed<2>(true);
+    chain.template setBypassed<3>(true);
+
+    //the number of coefficients follows the filter order, so every case falls through to the lower ones
+    switch( slope )
+    {
+        case Slope_48:
+            update<3>(chain, coefficients);
+            [[fallthrough]];
+        case Slope_36:
+            update<2>(chain, coefficients);
+            [[fallthrough]];
+        case Slope_24:
+            update<1>(chain, coefficients);
+            [[fallthrough]];
+        case Slope_12:
+            update<0>(chain, coefficients);
+    }
+}
+
+void OfflineEngine::prepare(double newSampleRate, int maximumBlockSize, const ChainSettings& chainSettings)
+{
+    sampleRate = newSampleRate;
+
+    juce::dsp::ProcessSpec spec;
+    spec.maximumBlockSize = juce::uint32(maximumBlockSize);
+    spec.numChannels = 1;
+    spec.sampleRate = sampleRate;
+
+    for( auto& chain : chains )
+        chain.prepare(spec);
+
+    doubleBuffer.setSize(int(chains.size()), maximumBlockSize);
+
+    lowCutFreq.reset(sampleRate, rampLengthSeconds);
+    highCutFreq.reset(sampleRate, rampLengthSeconds);
+    peakFreq.reset(sampleRate, rampLengthSeconds);
+    peakQuality.reset(sampleRate, rampLengthSeconds);
+    peakGainInDecibels.reset(sampleRate, rampLengthSeconds);
+
+    reset(chainSettings);
+}
+
+void OfflineEngine::reset(const ChainSettings& chainSettings)
+{
+    //start at the settings without ramping
+    lowCutFreq.setCurrentAndTargetValue(chainSettings.lowCutFreq);
+    highCutFreq.setCurrentAndTargetValue(chainSettings.highCutFreq);
+    peakFreq.setCurrentAndTargetValue(chainSettings.peakFreq);
+    peakQuality.setCurrentAndTargetValue(chainSettings.peakQuality);
+    peakGainInDecibels.setCurrentAndTargetValue(chainSettings.peakGainInDecibels);
+    lowCutSlope = chainSettings.lowCutSlope;
+    highCutSlope = chainSettings.highCutSlope;
+
+    updateChains();
+    chainsAtTarget = true;
+
+    for( auto& chain : chains )
+        chain.reset();
+}
+
+void OfflineEngine::setTargetSettings(const ChainSettings& chainSettings)
+{
+    lowCutFreq.setTargetValue(chainSettings.lowCutFreq);
+    highCutFreq.setTargetValue(chainSettings.highCutFreq);
+    peakFreq.setTargetValue(chainSettings.peakFreq);
+    peakQuality.setTargetValue(chainSettings.peakQuality);
+    peakGainInDecibels.setTargetValue(chainSettings.peakGainInDecibels);
+
+    //slopes can't be ramped, they are applied right away
+    if( chainSettings.lowCutSlope != lowCutSlope || chainSettings.highCutSlope != highCutSlope )
+    {
+        lowCutSlope = chainSettings.lowCutSlope;
+        highCutSlope = chainSettings.highCutSlope;
+        updateChains();
+    }
+}
+
+bool OfflineEngine::isSmoothing() const
+{
+    return lowCutFreq.isSmoothing() || highCutFreq.isSmoothing() || peakFreq.isSmoothing()
+        || peakQuality.isSmoothing() || peakGainInDecibels.isSmoothing();
+}
+
+void OfflineEngine::updateChains()
+{
+    using namespace juce::dsp;
+
+    auto peakCoefficients = IIR::Coefficients<double>::makePeakFilter(sampleRate,
+            peakFreq.getCurrentValue(),
+            peakQuality.getCurrentValue(),
+            juce::Decibels::decibelsToGain(peakGainInDecibels.getCurrentValue()));
+    auto lowCutCoefficients = FilterDesign<double>::designIIRHighpassHighOrderButterworthMethod(lowCutFreq.getCurrentValue(),
+            sampleRate,
+            2*(lowCutSlope+1));
+    auto highCutCoefficients = FilterDesign<double>::designIIRLowpassHighOrderButterworthMethod(highCutFreq.getCurrentValue(),
+            sampleRate,
+            2*(highCutSlope+1));
+
+    for( auto& chain : chains )
+    {
+        chain.get<ChainPositions::Peak>().coefficients = peakCoefficients;
+        updateCutFilter(chain.get<ChainPositions::LowCut>(), lowCutCoefficients, lowCutSlope);
+        updateCutFilter(chain.get<ChainPositions::HighCut>(), highCutCoefficients, highCutSlope);
+    }
+}
+
+void OfflineEngine::process(juce::AudioBuffer<float>& buffer)
+{
+    const int numChannels = juce::jmin(buffer.getNumChannels(), int(chains.size()));
+    const int numSamples = buffer.getNumSamples();
+
+    //offline, so growing the buffer for an unexpectedly large block is fine
+    if( numSamples > doubleBuffer.getNumSamples() )
+        doubleBuffer.setSize(int(chains.size()), numSamples);
+
+    for( int ch = 0; ch < numChannels; ++ch )
+    {
+        auto* src = buffer.getReadPointer(ch);
+        auto* dst = doubleBuffer.getWritePointer(ch);
+        for( int i = 0; i < numSamples; ++i )
+            dst[i] = src[i];
+    }
+
+    juce::dsp::AudioBlock<double> block(doubleBuffer.getArrayOfWritePointers(), size_t(numChannels), size_t(numSamples));
+
+    for( int start = 0; start < numSamples; )
+    {
+        //while ramping, the block is split so the coefficients follow the smoothed values closely,
+        //every piece is designed for the values at its first sample, then the smoothers move on to the next piece
+        int num = numSamples - start;
+        if( isSmoothing() )
+        {
+            num = juce::jmin(num, updateInterval);
+            updateChains();
+            lowCutFreq.skip(num);
+            highCutFreq.skip(num);
+            peakFreq.skip(num);
+            peakQuality.skip(num);
+            peakGainInDecibels.skip(num);
+            chainsAtTarget = false;
+        }
+        else if( ! chainsAtTarget )
+        {
+            //the ramp ended with the last piece, which was designed for the values at its start
+            updateChains();
+            chainsAtTarget = true;
+        }
+
+        auto subBlock = block.getSubBlock(size_t(start), size_t(num));
+        for( int ch = 0; ch < numChannels; ++ch )
+        {
+            auto channelBlock = subBlock.getSingleChannelBlock(size_t(ch));
+            juce::dsp::ProcessContextReplacing<double> context(channelBlock);
+            chains[size_t(ch)].process(context);
+        }
+
+        start += num;
+    }
+
+    for( int ch = 0; ch < numChannels; ++ch )
+    {
+        auto* src = doubleBuffer.getReadPointer(ch);
+        auto* dst = buffer.getWritePointer(ch);
+        for( int i = 0; i < numSamples; ++i )
+            dst[i] = float(src[i]);
+    }
+}
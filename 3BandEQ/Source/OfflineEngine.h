@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    OfflineEngine.h
+    Created: 18 Oct 2026
+
+    High quality engine used while the host renders offline: the chain runs
+    in double precision and its coefficients follow smoothed parameters
+    instead of jumping once per block. Like the realtime chain it has no
+    latency, so bounces line up with what is heard live.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+
+class OfflineEngine
+{
+public:
+  OfflineEngine() = default;
+
+  void prepare(double sampleRate, int maximumBlockSize, const ChainSettings& chainSettings);
+
+  //start from silence with the smoothers at these settings (e.g. for the next render), nothing is left of the last one
+  void reset(const ChainSettings& chainSettings);
+
+  //new settings are approached over rampLengthSeconds, slopes switch immediately
+  void setTargetSettings(const ChainSettings& chainSettings);
+
+  //process the first two channels of the buffer in double precision
+  void process(juce::AudioBuffer<float>& buffer);
+
+private:
+  using FilterD = juce::dsp::IIR::Filter<double>;
+  using CutFilterD = juce::dsp::ProcessorChain<FilterD, FilterD, FilterD, FilterD>;
+  using MonoChainD = juce::dsp::ProcessorChain<CutFilterD, FilterD, CutFilterD>;
+
+  //smoothing time of parameter changes
+  static constexpr double rampLengthSeconds = 0.05;
+  //while parameters are ramping, coefficients are redesigned every this many samples
+  static constexpr int updateInterval = 32;
+
+  bool isSmoothing() const;
+  //design the coefficients for the current (smoothed) values and apply them to both chains
+  void updateChains();
+
+  double sampleRate = 44100.0;
+  std::array<MonoChainD, 2> chains;
+  juce::AudioBuffer<double> doubleBuffer;
+
+  //frequencies and Q are smoothed on a logarithmic scale, the gain in decibels linearly
+  juce::SmoothedValue<double, juce::ValueSmoothingTypes::Multiplicative> lowCutFreq, highCutFreq, peakFreq, peakQuality;
+  juce::SmoothedValue<double, juce::ValueSmoothingTypes::Linear> peakGainInDecibels;
+  Slope lowCutSlope{Slope::Slope_12}, highCutSlope{Slope::Slope_12};
+  //false while the chains were last designed for a value on the way to the targets
+  bool chainsAtTarget = true;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OfflineEngine)
+};
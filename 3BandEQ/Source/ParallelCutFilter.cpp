@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    ParallelCutFilter.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "ParallelCutFilter.h"
+
+ParallelCutFilter::ParallelCutFilter()
+{
+    reset();
+}
+
+double ParallelCutFilter::expand(const double (*biquads)[5], int numBiquads, Section* sections)
+{
+    using Complex = std::complex<double>;
+
+    //in w = z^-1 every biquad is B(w) / A(w) with A(w) = 1 + a1 w + a2 w^2 = a2 (w - r1)(w - r2)
+    //the direct term is the value at w -> infinity
+    double direct = 1.0;
+    for( int i = 0; i < numBiquads; ++i )
+        direct *= biquads[i][2] / biquads[i][4];
+
+    auto evaluate = [](const double* c, Complex w, bool denominator)
+    {
+        return denominator ? 1.0 + c[3] * w + c[4] * w * w
+                           : c[0] + c[1] * w + c[2] * w * w;
+    };
+
+    for( int i = 0; i < numBiquads; ++i )
+    {
+        const double a1 = biquads[i][3], a2 = biquads[i][4];
+        jassert(a2 != 0.0);
+
+        const Complex root = std::sqrt(Complex(a1 * a1 - 4.0 * a2));
+        const Complex r1 = (-a1 + root) / (2.0 * a2);
+        const Complex r2 = (-a1 - root) / (2.0 * a2);
+
+        //residue of the whole cascade at r, evaluated in factored form
+        //(multiplying the cascade out first loses all precision for low cut frequencies)
+        auto residue = [&](Complex r, Complex otherRoot)
+        {
+            Complex value = evaluate(biquads[i], r, false) / (a2 * (r - otherRoot));
+            for( int j = 0; j < numBiquads; ++j )
+                if( j != i )
+                    value *= evaluate(biquads[j], r, false) / evaluate(biquads[j], r, true);
+            return value;
+        };
+
+        const Complex c1 = residue(r1, r2);
+        const Complex c2 = residue(r2, r1);
+
+        //c1 / (w - r1) + c2 / (w - r2) = a2 ((c1 + c2) w - (c1 r2 + c2 r1)) / (1 + a1 w + a2 w^2)
+        sections[i].b0 = (-(c1 * r2 + c2 * r1) * a2).real();
+        sections[i].b1 = ((c1 + c2) * a2).real();
+        sections[i].a1 = a1;
+        sections[i].a2 = a2;
+    }
+
+    return direct;
+}
+
+void ParallelCutFilter::setCoefficients(const double (*biquads)[5], int numBiquads)
+{
+    numBiquads = juce::jmin(numBiquads, maxSections);
+
+    //a different number of sections is a different structure, the old state doesn't belong to it
+    if( numBiquads != numSections )
+        reset();
+    numSections = numBiquads;
+
+    Section sections[maxSections];
+    direct = expand(biquads, numBiquads, sections);
+
+    //unused lanes get zero coefficients, so they always output 0
+    for( int r = 0; r < numRegisters; ++r )
+    {
+        b0[r] = b1[r] = minusA1[r] = minusA2[r] = Lanes::expand(0.0);
+
+        for( size_t lane = 0; lane < Lanes::SIMDNumElements; ++lane )
+        {
+            const int i = r * int(Lanes::SIMDNumElements) + int(lane);
+            if( i >= numBiquads )
+                break;
+
+            b0[r].set(lane, sections[i].b0);
+            b1[r].set(lane, sections[i].b1);
+            minusA1[r].set(lane, -sections[i].a1);
+            minusA2[r].set(lane, -sections[i].a2);
+        }
+    }
+
+    numActiveRegisters = int((size_t(numBiquads) + Lanes::SIMDNumElements - 1) / Lanes::SIMDNumElements);
+}
+
+void ParallelCutFilter::reset()
+{
+    for( int r = 0; r < numRegisters; ++r )
+        s1[r] = s2[r] = Lanes::expand(0.0);
+}
+
+void ParallelCutFilter::process(float* data, int numSamples)
+{
+    for( int i = 0; i < numSamples; ++i )
+    {
+        const auto x = Lanes::expand(double(data[i]));
+        double y = direct * data[i];
+
+        //every section sees the same input, so there's no dependency between the lanes
+        for( int r = 0; r < numActiveRegisters; ++r )
+        {
+            const auto out = b0[r] * x + s1[r];
+            s1[r] = b1[r] * x + minusA1[r] * out + s2[r];
+            s2[r] = minusA2[r] * out;
+            y += out.sum();
+        }
+
+        data[i] = float(y);
+    }
+
+    //same as juce::dsp::IIR::Filter, keep denormals out of the state
+    for( int r = 0; r < numActiveRegisters; ++r )
+    {
+        for( size_t lane = 0; lane < Lanes::SIMDNumElements; ++lane )
+        {
+            auto v1 = s1[r].get(lane), v2 = s2[r].get(lane);
+            juce::dsp::util::snapToZero(v1);
+            juce::dsp::util::snapToZero(v2);
+            s1[r].set(lane, v1);
+            s2[r].set(lane, v2);
+        }
+    }
+}
@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+    ParallelRenderer.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "ParallelRenderer.h"
+
+void ParallelRenderer::Cascade::reset()
+{
+    for( auto& stage : stages )
+        stage.s1 = stage.s2 = 0.0;
+}
+
+void ParallelRenderer::Cascade::process(const float* input, float* output, int numSamples)
+{
+    for( int i = 0; i < numSamples; ++i )
+    {
+        double x = input[i];
+
+        //transposed direct form II, same as juce::dsp::IIR::Filter
+        for( int n = 0; n < numStages; ++n )
+        {
+            auto& s = stages[size_t(n)];
+            const double y = s.b0 * x + s.s1;
+            s.s1 = s.b1 * x - s.a1 * y + s.s2;
+            s.s2 = s.b2 * x - s.a2 * y;
+            x = y;
+        }
+
+        output[i] = float(x);
+    }
+}
+
+void ParallelRenderer::Cascade::warmUp(const float* input, int numSamples)
+{
+    float discarded[256];
+
+    for( int i = 0; i < numSamples; i += 256 )
+    {
+        const int num = juce::jmin(256, numSamples - i);
+        process(input + i, discarded, num);
+    }
+}
+
+ParallelRenderer::Cascade ParallelRenderer::makeCascade(const ChainSettings& chainSettings, double sampleRate)
+{
+    using namespace juce::dsp;
+
+    Cascade cascade;
+
+    auto add = [&cascade](const auto& coefficients)
+    {
+        auto* c = coefficients->getRawCoefficients();
+        auto& stage = cascade.stages[size_t(cascade.numStages++)];
+        stage.b0 = c[0];
+        stage.b1 = c[1];
+        stage.b2 = c[2];
+        stage.a1 = c[3];
+        stage.a2 = c[4];
+    };
+
+    //same order as the MonoChain: low cut, peak, high cut
+    for( auto& c : FilterDesign<double>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq,
+                                                                                     sampleRate,
+                                                                                     2*(chainSettings.lowCutSlope+1)) )
+        add(c);
+
+    add(IIR::Coefficients<double>::makePeakFilter(sampleRate,
+                                                  chainSettings.peakFreq,
+                                                  chainSettings.peakQuality,
+                                                  juce::Decibels::decibelsToGain(double(chainSettings.peakGainInDecibels))));
+
+    for( auto& c : FilterDesign<double>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq,
+                                                                                    sampleRate,
+                                                                                    2*(chainSettings.highCutSlope+1)) )
+        add(c);
+
+    return cascade;
+}
+
+int ParallelRenderer::computeWarmUpLength(const ChainSettings& chainSettings, double sampleRate)
+{
+    auto cascade = makeCascade(chainSettings, sampleRate);
+
+    //run an impulse through the chain until it stayed below the threshold for a second (or a minute has passed)
+    const int blockSize = 1024;
+    const int maxLength = int(sampleRate * 60.0);
+    const int quietLength = int(sampleRate);
+
+    std::vector<float> in(size_t(blockSize), 0.f), out(size_t(blockSize));
+    in[0] = 1.f;
+
+    int lastAbove = 0;
+    for( int start = 0; start < maxLength && start - lastAbove < quietLength; start += blockSize )
+    {
+        cascade.process(in.data(), out.data(), blockSize);
+        in[0] = 0.f;
+
+        for( int i = 0; i < blockSize; ++i )
+            if( std::abs(out[size_t(i)]) > decayThreshold )
+                lastAbove = start + i;
+    }
+
+    return juce::jmax(64, lastAbove + 1);
+}
+
+//==============================================================================
+ParallelRenderer::ParallelRenderer(const ChainSettings& chainSettings, double sampleRate, int numChannels,
+                                   juce::ThreadPool& threadPool, int segments)
+    : pool(threadPool),
+      numSegments(segments > 0 ? segments : threadPool.getNumThreads()),
+      prototype(makeCascade(chainSettings, sampleRate)),
+      carry(size_t(numChannels), prototype),
+      warmUpLength(computeWarmUpLength(chainSettings, sampleRate))
+{
+}
+
+void ParallelRenderer::reset()
+{
+    for( auto& c : carry )
+        c.reset();
+}
+
+void ParallelRenderer::processSequential(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output)
+{
+    const int numChannels = juce::jmin(input.getNumChannels(), output.getNumChannels(), int(carry.size()));
+
+    for( int ch = 0; ch < numChannels; ++ch )
+        carry[size_t(ch)].process(input.getReadPointer(ch), output.getWritePointer(ch), input.getNumSamples());
+}
+
+void ParallelRenderer::process(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output)
+{
+    //segments warm up on the input before them, so it has to stay untouched
+    jassert(&input != &output);
+
+    const int numChannels = juce::jmin(input.getNumChannels(), output.getNumChannels(), int(carry.size()));
+    const int numSamples = input.getNumSamples();
+
+    //no job would be started, so none would signal the wait below
+    if( numChannels <= 0 || numSamples <= 0 )
+        return;
+
+    //segments shorter than a few warm-up lengths would spend most of their time warming up
+    const int segments = juce::jlimit(1, juce::jmax(1, numSegments), numSamples / (4 * warmUpLength));
+    if( segments == 1 )
+    {
+        processSequential(input, output);
+        return;
+    }
+
+    const int segmentLength = (numSamples + segments - 1) / segments;
+
+    //fetch the pointers up front, the jobs must not touch the buffer objects concurrently
+    auto* const* inputs = input.getArrayOfReadPointers();
+    auto* const* outputs = output.getArrayOfWritePointers();
+
+    std::vector<Cascade> lastSegmentStates(size_t(numChannels));
+    std::atomic<int> remaining{segments * numChannels};
+    juce::WaitableEvent finished;
+
+    for( int ch = 0; ch < numChannels; ++ch )
+    {
+        for( int seg = 0; seg < segments; ++seg )
+        {
+            pool.addJob([&, ch, seg]
+            {
+                const int start = seg * segmentLength;
+                const int end = juce::jmin(numSamples, start + segmentLength);
+                auto* in = inputs[ch];
+
+                //the first segment continues the previous chunk, all others start fresh and warm up
+                Cascade cascade = carry[size_t(ch)];
+                if( seg > 0 )
+                {
+                    cascade.reset();
+                    cascade.warmUp(in + start - warmUpLength, warmUpLength);
+                }
+
+                if( end > start )
+                    cascade.process(in + start, outputs[ch] + start, end - start);
+
+                if( seg == segments - 1 )
+                    lastSegmentStates[size_t(ch)] = cascade;
+
+                if( --remaining == 0 )
+                    finished.signal();
+            });
+        }
+    }
+
+    finished.wait();
+
+    //the last segment's state carries over into the next chunk
+    for( int ch = 0; ch < numChannels; ++ch )
+        carry[size_t(ch)] = lastSegmentStates[size_t(ch)];
+}
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    ParallelRenderer.h
+    Created: 18 Oct 2026
+
+    Offline rendering of one long stream on several cores. Every chunk of the
+    stream is split into segments that are filtered in parallel. Each segment
+    except the first starts with a fresh chain that is warmed up on the input
+    preceding it, for as long as the chain's impulse response takes to decay.
+    The stitched output matches a sequential render within that decay
+    threshold.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+
+class ParallelRenderer
+{
+public:
+  //numSegments of 0 uses one segment per thread of the pool
+  ParallelRenderer(const ChainSettings& chainSettings, double sampleRate, int numChannels,
+                   juce::ThreadPool& pool, int numSegments = 0);
+
+  //impulse response level below which the chain counts as decayed (about -140 dB)
+  static constexpr double decayThreshold = 1.0e-7;
+
+  //samples the chain's impulse response needs to decay below decayThreshold
+  static int computeWarmUpLength(const ChainSettings& chainSettings, double sampleRate);
+  int getWarmUpLength() const { return warmUpLength; }
+
+  //render the next chunk of the stream, chunks have to be passed in order
+  void process(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output);
+  //render the next chunk on the calling thread only (reference for verification and speedup)
+  void processSequential(const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output);
+
+  //restart the stream
+  void reset();
+
+  //biquad cascade in double precision that can be copied around with its state
+  struct Cascade
+  {
+    struct Biquad
+    {
+      double b0{1}, b1{0}, b2{0}, a1{0}, a2{0};
+      double s1{0}, s2{0};
+    };
+
+    std::array<Biquad, 9> stages;
+    int numStages = 0;
+
+    void reset();
+    void process(const float* input, float* output, int numSamples);
+    //run the input through the cascade only to settle its state
+    void warmUp(const float* input, int numSamples);
+  };
+
+  static Cascade makeCascade(const ChainSettings& chainSettings, double sampleRate);
+
+private:
+  juce::ThreadPool& pool;
+  int numSegments;
+  Cascade prototype;
+  //state at the end of the previous chunk, one per channel
+  std::vector<Cascade> carry;
+  int warmUpLength;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelRenderer)
+};
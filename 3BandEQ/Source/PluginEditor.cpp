@@ -11,118 +11,198 @@
 //===============================ResponseCurveComponent===============================================
 ResponseCurveComponent::ResponseCurveComponent(_3BandEQAudioProcessor& p) : audioProcessor(p)
 {
-  //get all the parameters
+  renderIdle.signal();
+
+  //listen only to the parameters the curve is drawn from, the governor's tier changes from the audio thread all the time
   const auto& params = audioProcessor.getParameters();
-  //set up listener to parameter changes
+  parameterSets.assign(size_t(params.size()), -1);
   for( auto param : params )
   {
+    auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(param);
+    if( withID == nullptr )
+      continue;
+
+    const int set = getChainParameterSet(withID->paramID);
+    if( set < 0 && withID->paramID != "Stereo Mode" )
+      continue;
+
+    parameterSets[size_t(param->getParameterIndex())] = set;
+    curveParameters.add(param);
     param->addListener(this);
   }
-
-  //start Timer for repainting (60 Hz refresh rate)
-  startTimerHz(60);
+  stereoMode = audioProcessor.apvts.getRawParameterValue("Stereo Mode");
+  //and to sample rate changes
+  audioProcessor.sampleRateChanges.addChangeListener(this);
 }
 ResponseCurveComponent::~ResponseCurveComponent()
 {
-  //get all the parameters
-  const auto& params = audioProcessor.getParameters();
   //deregister listeners
-  for( auto param : params )
+  for( auto param : curveParameters )
   {
     param->removeListener(this);
   }
+  audioProcessor.sampleRateChanges.removeChangeListener(this);
+
+  //a queued job has nothing left to do, a running one is waited for
+  {
+    const juce::ScopedLock sl(renderLock);
+    curveOutdated = false;
+  }
+  renderIdle.wait();
+  //the job signals while it still holds the lock, it's done once the lock is free again
+  const juce::ScopedLock sl(renderLock);
 }
 
 //==============================================================================
 
 void ResponseCurveComponent::parameterValueChanged (int parameterIndex, float newValue)
 {
-  //set atomic flag parametersChanged true if parameter value changed
-  parametersChanged.set(true);
+  //can be called from any thread, the audio thread included, so nothing here locks or allocates:
+  //the render job is queued from handleAsyncUpdate
+  //(the second parameter set isn't drawn while both channels use the first one)
+  if( parameterSets[size_t(parameterIndex)] == 1 && int(stereoMode->load()) == StereoMode::Linked )
+    return;
+
+  parametersOutdated = true;
+  triggerAsyncUpdate();
+}
+
+void ResponseCurveComponent::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+  requestCurve();
 }
 
-void ResponseCurveComponent::timerCallback()
+void ResponseCurveComponent::handleAsyncUpdate()
+{
+  if( parametersOutdated.exchange(false) )
+    requestCurve();
+
+  //signal a repaint to draw new response curve (the OS coalesces it with the display refresh)
+  if( curveReady.exchange(false) )
+    repaint();
+}
+
+void ResponseCurveComponent::visibilityChanged()
+{
+  updateShowing();
+}
+
+void ResponseCurveComponent::parentHierarchyChanged()
+{
+  updateShowing();
+}
+
+void ResponseCurveComponent::updateShowing()
 {
-  //check if parametersChanged is true, reset it to false and do stuff
-  if( parametersChanged.compareAndSetBool(false, true))
   {
-    //update the monoChain
-    auto chainSettings = getChainSettings(audioProcessor.apvts);
-    auto peakCoefficients = makePeakFilter(chainSettings, audioProcessor.getSampleRate());
-    auto lowCutCoefficients = makeLowCutFilter(chainSettings, audioProcessor.getSampleRate());
-    auto highCutCoefficients = makeHighCutFilter(chainSettings, audioProcessor.getSampleRate());
+    const juce::ScopedLock sl(renderLock);
+    showing = isShowing();
+  }
+  //catch up with everything that changed while hidden
+  requestCurve();
+}
 
-    updateCoefficients(monoChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    updateCutFilter(monoChain.get<ChainPositions::LowCut>(), lowCutCoefficients, chainSettings.lowCutSlope);
-    updateCutFilter(monoChain.get<ChainPositions::HighCut>(), highCutCoefficients, chainSettings.highCutSlope);
+void ResponseCurveComponent::requestCurve()
+{
+  const juce::ScopedLock sl(renderLock);
+  curveOutdated = true;
 
+  if( renderJobQueued || ! showing )
+    return;
 
-    //signal a repaint to draw new response curve
-    repaint();
+  renderJobQueued = true;
+  renderIdle.reset();
+  renderPool->pool.addJob([this] { renderCurves(); });
+}
+
+void ResponseCurveComponent::renderCurves()
+{
+  for( ;; )
+  {
+    juce::Rectangle<int> area;
+    {
+      const juce::ScopedLock sl(renderLock);
+      //changes during rendering are picked up by the next round of the loop
+      if( ! curveOutdated || ! showing )
+      {
+        renderJobQueued = false;
+        renderIdle.signal();
+        return;
+      }
+      curveOutdated = false;
+      area = curveArea;
+    }
+
+    //the second parameter set only has a curve of its own while the channels are filtered separately
+    const auto sampleRate = audioProcessor.getSampleRate();
+    const auto mode = static_cast<StereoMode>(int(stereoMode->load()));
+    juce::Path curves[2];
+    curves[0] = renderCurve(area, sampleRate, getChainSettings(audioProcessor.apvts, 0));
+    if( mode != StereoMode::Linked )
+      curves[1] = renderCurve(area, sampleRate, getChainSettings(audioProcessor.apvts, 1));
+
+    {
+      const juce::ScopedLock sl(renderLock);
+      responseCurves[0].swapWithPath(curves[0]);
+      responseCurves[1].swapWithPath(curves[1]);
+      curveMode = mode;
+    }
+    curveReady = true;
+    triggerAsyncUpdate();
   }
 }
 
-void ResponseCurveComponent::paint (juce::Graphics& g)
+juce::Path ResponseCurveComponent::renderCurve(juce::Rectangle<int> responseArea, double sampleRate, const ChainSettings& chainSettings)
 {
     using namespace juce;
-    // (Our component is opaque, so we must completely fill the background with a solid colour)
-    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
-
-    g.drawImage(background, getLocalBounds().toFloat());
 
-    //bounding box
-    auto responseArea = getAnalysisArea();
     //width of response curve area
     auto w = responseArea.getWidth();
+    if( w <= 0 || sampleRate <= 0.0 )
+      return {};
 
-    //chain elements
-    auto& lowCut = monoChain.get<ChainPositions::LowCut>();
-    auto& peak = monoChain.get<ChainPositions::Peak>();
-    auto& highCut = monoChain.get<ChainPositions::HighCut>();
+    //get the coefficient sets from the shared cache (designed once for all open editors with the same settings)
+    auto peakCoefficients = coefficientCache->getPeak(chainSettings, sampleRate);
+    auto lowCutCoefficients = coefficientCache->getLowCut(chainSettings, sampleRate);
+    auto highCutCoefficients = coefficientCache->getHighCut(chainSettings, sampleRate);
 
-    //the sample rate form audioProcessor
-    auto sampleRate = audioProcessor.getSampleRate();
+    //map pixel coordinates to hearable range of 20 Hz to 20 kHz, only when the grid changed
+    if( int(cosW.size()) != w || gridSampleRate != sampleRate )
+    {
+      cosW.resize(w);
+      cos2W.resize(w);
+      for( int i = 0; i < w; ++i )
+      {
+        auto freq = mapToLog10(double(i) / double(w), 20.0, 20000.0);
+        auto omega = MathConstants<double>::twoPi * freq / sampleRate;
+        cosW[i] = std::cos(omega);
+        cos2W[i] = std::cos(2.0 * omega);
+      }
+      gridSampleRate = sampleRate;
+    }
 
-    //vector to store the magnitudes
-    std::vector<double> mags;
-    //we need as many magnitues as there are pixels in width
-    mags.resize(w);
+    //vector to store the magnitudes, squared while the filters are multiplied in
+    //(start at 1, not 0 because it will be multiplied later)
+    std::vector<double> mags(w, 1.0);
 
-    //compute magnitude for each pixel (or frequency)
-    for( int i = 0; i < w; ++i)
+    //all pixels of one biquad at once, with the kernel variant picked for this CPU
+    //the cut filter sets only contain the active biquads, so there's nothing to check for bypass
+    auto& kernels = DspKernels::get();
+    for( auto* set : { lowCutCoefficients.get(), peakCoefficients.get(), highCutCoefficients.get() } )
     {
-      //set magnitude to 1 (not 0 because it will be multiplied later)
-      double mag = 1.f;
-      //map pixel coordinates to hearable range of 20 Hz to 20 kHz
-      auto freq = mapToLog10(double(i) / double(w), 20.0, 20000.0);
-
-      //check if band is bypassed
-      if(! monoChain.isBypassed<ChainPositions::Peak>())
-        mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
-      //check for bypassed in all the low and highcuts
-      if(! lowCut.isBypassed<0>())
-        mag *= lowCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-      if(! lowCut.isBypassed<1>())
-        mag *= lowCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-      if(! lowCut.isBypassed<2>())
-        mag *= lowCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-      if(! lowCut.isBypassed<3>())
-        mag *= lowCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-
-      if(! highCut.isBypassed<0>())
-        mag *= highCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-      if(! highCut.isBypassed<1>())
-        mag *= highCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-      if(! highCut.isBypassed<2>())
-        mag *= highCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-      if(! highCut.isBypassed<3>())
-        mag *= highCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-
-      //convert magnitude into db and store
-      mags[i] = Decibels::gainToDecibels(mag);
+      for( auto* coefficients : set->coefficients )
+      {
+        auto* c = coefficients->getRawCoefficients();
+        kernels.multiplySquaredMagnitudes({ c[0], c[1], c[2], c[3], c[4] }, cosW.data(), cos2W.data(), mags.data(), w);
+      }
     }
+
+    //convert squared magnitude into db
+    for( auto& mag : mags )
+      mag = Decibels::gainToDecibels(std::sqrt(mag));
+
     //convert magnitude vector into Path
-    Path responseCurve;
+    Path curve;
     //response area bottom and top
     const double outputMin = responseArea.getBottom();
     const double outputMax = responseArea.getY();
@@ -133,23 +213,78 @@ void ResponseCurveComponent::paint (juce::Graphics& g)
     };
 
     //start path at first magnitude entry
-    responseCurve.startNewSubPath(responseArea.getX(), map(mags.front()));
+    curve.startNewSubPath(responseArea.getX(), map(mags.front()));
     //loop through all magnitude entries and connect them
     for( size_t i = 1; i < mags.size(); ++i )
     {
-      responseCurve.lineTo(responseArea.getX() + i, map(mags[i]));
+      curve.lineTo(responseArea.getX() + i, map(mags[i]));
     }
 
+    return curve;
+}
+
+void ResponseCurveComponent::paint (juce::Graphics& g)
+{
+    using namespace juce;
+    // (Our component is opaque, so we must completely fill the background with a solid colour)
+    g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
+
+    //the background is only drawn once the component is actually painted at its size
+    if( background.isNull() )
+      drawBackground();
+
+    g.drawImage(background, getLocalBounds().toFloat());
+
     //draw boundary box
     g.setColour(getLookAndFeel().findColour (juce::Slider::thumbColourId));
     g.drawRoundedRectangle(getRenderArea().toFloat(), 4.f, 1.f);
 
-    //draw response curve
-    g.setColour(Colours::white);
-    g.strokePath(responseCurve, PathStrokeType(2.f));
+    //latest finished response curves
+    Path curves[2];
+    StereoMode mode;
+    {
+      const ScopedLock sl(renderLock);
+      curves[0] = responseCurves[0];
+      curves[1] = responseCurves[1];
+      mode = curveMode;
+    }
+
+    //draw response curves, the second set's under the first one
+    const Colour colours[] = { Colours::white, Colours::orange };
+    g.setColour(colours[1]);
+    g.strokePath(curves[1], PathStrokeType(2.f));
+    g.setColour(colours[0]);
+    g.strokePath(curves[0], PathStrokeType(2.f));
+
+    //while the channels are filtered separately, a legend tells which curve is which
+    if( mode != StereoMode::Linked )
+    {
+      const char* names[2][2] = { { "L", "R" }, { "M", "S" } };
+      auto legend = getAnalysisArea().reduced(4).removeFromTop(12).removeFromRight(30);
+      g.setFont(10.f);
+      for( int set = 0; set < 2; ++set )
+      {
+        g.setColour(colours[set]);
+        g.drawFittedText(names[mode == StereoMode::MidSide ? 1 : 0][set], legend.removeFromLeft(15),
+                         Justification::centred, 1);
+      }
+    }
 }
 
 void ResponseCurveComponent::resized()
+{
+  //the background is redrawn at the new size the next time it's painted
+  background = juce::Image();
+
+  {
+    const juce::ScopedLock sl(renderLock);
+    curveArea = getAnalysisArea();
+  }
+  //the curve is rendered again for the new width
+  requestCurve();
+}
+
+void ResponseCurveComponent::drawBackground()
 {
   using namespace juce;
   //make background image
@@ -300,17 +435,152 @@ juce::Rectangle<int> ResponseCurveComponent::getAnalysisArea()
   return bounds;
 }
 
+//===============================PresetBrowser===============================================
+PresetBrowser::PresetBrowser(_3BandEQAudioProcessor& p) : audioProcessor(p)
+{
+  //the indexed presets are shown right away, the folder is compared with them in the background
+  library->addChangeListener(this);
+  library->checkFolder();
+
+  searchBox.setTextToShowWhenEmpty("search name or tag", juce::Colours::grey);
+  searchBox.onTextChange = [this] { updateFilter(); };
+  addAndMakeVisible(searchBox);
+
+  //rows are only painted while they're visible, so the number of presets doesn't matter
+  list.setModel(this);
+  list.setRowHeight(32);
+  addAndMakeVisible(list);
+
+  saveButton.onClick = [this] { saveCurrentState(); };
+  addAndMakeVisible(saveButton);
+
+  updateFilter();
+  setSize(360, 420);
+}
+
+PresetBrowser::~PresetBrowser()
+{
+  library->removeChangeListener(this);
+}
+
+void PresetBrowser::resized()
+{
+  auto bounds = getLocalBounds().reduced(4);
+  auto top = bounds.removeFromTop(24);
+  saveButton.setBounds(top.removeFromRight(70));
+  top.removeFromRight(4);
+  searchBox.setBounds(top);
+  bounds.removeFromTop(4);
+  list.setBounds(bounds);
+}
+
+int PresetBrowser::getNumRows()
+{
+  return int(rows.size());
+}
+
+void PresetBrowser::paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected)
+{
+  using namespace juce;
+  if( rowNumber < 0 || rowNumber >= int(rows.size()) )
+    return;
+
+  const auto& preset = library->getPreset(rows[size_t(rowNumber)]);
+
+  if( rowIsSelected )
+    g.fillAll(getLookAndFeel().findColour(Slider::thumbColourId).withAlpha(0.4f));
+
+  //thumbnail from the cached curve, same scale as the response curve (-24 to +24 dB)
+  auto thumbnail = Rectangle<float>(2.f, 2.f, 72.f, float(height) - 4.f);
+  g.setColour(Colours::dimgrey);
+  g.drawRect(thumbnail);
+
+  Path curve;
+  for( int i = 0; i < PresetInfo::numCurvePoints; ++i )
+  {
+    const float x = jmap(float(i), 0.f, float(PresetInfo::numCurvePoints - 1), thumbnail.getX(), thumbnail.getRight());
+    const float y = jmap(jlimit(-24.f, 24.f, preset.getCurveDecibels(i)), -24.f, 24.f, thumbnail.getBottom(), thumbnail.getY());
+    if( i == 0 )
+      curve.startNewSubPath(x, y);
+    else
+      curve.lineTo(x, y);
+  }
+  g.setColour(Colours::white);
+  g.strokePath(curve, PathStrokeType(1.f));
+
+  //name on top, tags below
+  auto text = Rectangle<int>(80, 0, width - 84, height);
+  g.setFont(14.f);
+  g.drawText(preset.name, text.removeFromTop(height / 2), Justification::bottomLeft, true);
+  g.setColour(Colours::grey);
+  g.setFont(11.f);
+  g.drawText(preset.tags, text, Justification::topLeft, true);
+}
+
+void PresetBrowser::selectedRowsChanged(int lastRowSelected)
+{
+  if( lastRowSelected < 0 || lastRowSelected >= int(rows.size()) )
+    return;
+
+  //the full state is read now, not while browsing
+  audioProcessor.loadPreset(library->loadState(rows[size_t(lastRowSelected)]));
+}
+
+void PresetBrowser::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+  updateFilter();
+}
+
+void PresetBrowser::updateFilter()
+{
+  const auto search = searchBox.getText().trim();
+
+  rows.clear();
+  for( int i = 0; i < library->getNumPresets(); ++i )
+  {
+    const auto& preset = library->getPreset(i);
+    if( search.isEmpty() || preset.name.containsIgnoreCase(search) || preset.tags.containsIgnoreCase(search) )
+      rows.push_back(i);
+  }
+
+  list.updateContent();
+  list.deselectAllRows();
+  list.repaint();
+}
+
+void PresetBrowser::saveCurrentState()
+{
+  auto* window = new juce::AlertWindow("Save Preset", "Name and tags (separated by spaces) of the preset",
+                                       juce::AlertWindow::NoIcon);
+  window->addTextEditor("name", "", "Name");
+  window->addTextEditor("tags", "", "Tags");
+  window->addButton("Save", 1, juce::KeyPress(juce::KeyPress::returnKey));
+  window->addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+
+  juce::Component::SafePointer<PresetBrowser> safeThis(this);
+  window->enterModalState(true, juce::ModalCallbackFunction::create([safeThis, window](int button)
+  {
+    const auto name = window->getTextEditorContents("name").trim();
+    if( button == 0 || name.isEmpty() || safeThis == nullptr )
+      return;
+
+    auto result = safeThis->library->savePreset(name, window->getTextEditorContents("tags").trim(),
+                                                safeThis->audioProcessor.getPresetState());
+    if( result.failed() )
+      juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Save Preset", result.getErrorMessage());
+
+    safeThis->updateFilter();
+  }), true);
+}
+
+
 //===================================_3BandEQAudioProcessorEditor===========================================
 _3BandEQAudioProcessorEditor::_3BandEQAudioProcessorEditor (_3BandEQAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p),
     responseCurveComponent(audioProcessor),
-    peakFreqSliderAttachment(audioProcessor.apvts, "Peak Freq", peakFreqSlider),
-    peakGainSliderAttachment(audioProcessor.apvts, "Peak Gain", peakGainSlider),
-    peakQualitySliderAttachment(audioProcessor.apvts, "Peak Quality", peakQualitySlider),
-    lowCutFreqSliderAttachment(audioProcessor.apvts, "LowCut Freq", lowCutFreqSlider),
-    highCutFreqSliderAttachment(audioProcessor.apvts, "HighCut Freq", highCutFreqSlider),
-    lowCutSlopeSliderAttachment(audioProcessor.apvts, "LowCut Slope", lowCutSlopeSlider),
-    highCutSlopeSliderAttachment(audioProcessor.apvts, "HighCut Slope", highCutSlopeSlider)
+    autoGainButtonAttachment(audioProcessor.apvts, "Auto Gain", autoGainButton),
+    crossoverButtonAttachment(audioProcessor.apvts, "Crossover", crossoverButton),
+    governorButtonAttachment(audioProcessor.apvts, "Governor", governorButton)
 {
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
@@ -320,12 +590,62 @@ _3BandEQAudioProcessorEditor::_3BandEQAudioProcessorEditor (_3BandEQAudioProcess
     {
       addAndMakeVisible(comp);
     }
-    //plugin window size
-    setSize (600, 400);
+
+    attachSliders(0);
+
+    //the label follows the tier parameter, which the processor only sets on the message thread
+    qualityTierAttachment = std::make_unique<juce::ParameterAttachment>(*audioProcessor.apvts.getParameter("Quality Tier"),
+        [this](float tier) { qualityTierLabel.setText("quality: " + QualityGovernor::getTierName(int(tier)), juce::dontSendNotification); });
+    qualityTierAttachment->sendInitialUpdate();
+
+    presetsButton.onClick = [this]
+    {
+        juce::CallOutBox::launchAsynchronously(std::make_unique<PresetBrowser>(audioProcessor),
+                                               presetsButton.getScreenBounds(), nullptr);
+    };
+
+    //the items have to be there before the attachment selects one
+    stereoModeBox.addItemList(audioProcessor.apvts.getParameter("Stereo Mode")->getAllValueStrings(), 1);
+    stereoModeBox.setTooltip("Dual Mono and Mid/Side filter the right or side channel with the \"R/S\" parameters");
+    //set before the attachment, which selects the mode's item (also when the host changes it)
+    stereoModeBox.onChange = [this] { updateParameterSetButtons(); };
+    stereoModeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts,
+                                                                                                    "Stereo Mode", stereoModeBox);
+
+    //the sliders edit one parameter set at a time
+    for(auto* button : { &firstSetButton, &secondSetButton })
+    {
+        button->setRadioGroupId(1);
+        button->setClickingTogglesState(true);
+    }
+    firstSetButton.setToggleState(true, juce::dontSendNotification);
+    firstSetButton.setTooltip("The sliders edit the left or mid channel's parameters");
+    secondSetButton.setTooltip("The sliders edit the right or side channel's parameters");
+    firstSetButton.onClick = [this] { attachSliders(0); };
+    secondSetButton.onClick = [this] { attachSliders(1); };
+    updateParameterSetButtons();
+
+    midiLearnButton.setTooltip("Control parameters with MIDI controllers");
+    midiLearnButton.onClick = [this] { showMidiLearnMenu(); };
+    audioProcessor.midiLearnChanges.addChangeListener(this);
+    changeListenerCallback(nullptr);
+
+    crossoverButton.setTooltip("Split at the low cut and high cut frequencies into the main, Mid and High outputs");
+
+    matchButton.setTooltip("Fit the filters so a source file sounds like a reference file");
+    matchButton.onClick = [this] { chooseMatchFiles(); };
+
+    //plugin window size (the bottom strip holds the buttons)
+    setSize (900, 428);
 }
 
 _3BandEQAudioProcessorEditor::~_3BandEQAudioProcessorEditor()
 {
+    audioProcessor.midiLearnChanges.removeChangeListener(this);
+
+    //a running match stops at its next block of frames, wait for it however long that takes,
+    //the pool's own destructor would give up after 5 seconds and delete the job while it runs
+    matchPool.removeAllJobs(true, -1);
 }
 
 //==============================================================================
@@ -343,6 +663,21 @@ void _3BandEQAudioProcessorEditor::resized()
 
     //bounding box
     auto bounds = getLocalBounds();
+    //strip at the bottom for buttons
+    auto buttonArea = bounds.removeFromBottom(28).reduced(4);
+    matchButton.setBounds(buttonArea.removeFromRight(100));
+    buttonArea.removeFromRight(4);
+    presetsButton.setBounds(buttonArea.removeFromRight(100));
+    buttonArea.removeFromRight(4);
+    midiLearnButton.setBounds(buttonArea.removeFromRight(60));
+    autoGainButton.setBounds(buttonArea.removeFromLeft(90));
+    crossoverButton.setBounds(buttonArea.removeFromLeft(90));
+    stereoModeBox.setBounds(buttonArea.removeFromLeft(100));
+    firstSetButton.setBounds(buttonArea.removeFromLeft(50));
+    secondSetButton.setBounds(buttonArea.removeFromLeft(50));
+    buttonArea.removeFromLeft(4);
+    governorButton.setBounds(buttonArea.removeFromLeft(90));
+    qualityTierLabel.setBounds(buttonArea.removeFromLeft(170));
     //top third of the window is for response curve
     auto responseArea = bounds.removeFromTop(bounds.getHeight() * 0.33);
     //make responseCurveComponent inside of this area
@@ -413,13 +748,219 @@ std::vector<juce::Component*> _3BandEQAudioProcessorEditor::getComps()
     &lowCutFreqLabel,
     &highCutFreqLabel,
     &lowCutSlopeLabel,
-    &highCutSlopeLabel
+    &highCutSlopeLabel,
+    &matchButton,
+    &presetsButton,
+    &midiLearnButton,
+    &autoGainButton,
+    &crossoverButton,
+    &stereoModeBox,
+    &firstSetButton,
+    &secondSetButton,
+    &governorButton,
+    &qualityTierLabel
   };
 }
 
+void _3BandEQAudioProcessorEditor::attachSliders(int parameterSet)
+{
+    if(parameterSet == editedParameterSet && peakFreqSliderAttachment != nullptr)
+        return;
+
+    editedParameterSet = parameterSet;
+
+    //the old attachment lets go of its parameter before the new one sets the slider to the other set's value
+    auto attach = [this, parameterSet](std::unique_ptr<Attachment>& attachment, const juce::String& parameterID, juce::Slider& slider)
+    {
+        attachment.reset();
+        attachment = std::make_unique<Attachment>(audioProcessor.apvts, getChainParameterID(parameterID, parameterSet), slider);
+    };
+    attach(peakFreqSliderAttachment, "Peak Freq", peakFreqSlider);
+    attach(peakGainSliderAttachment, "Peak Gain", peakGainSlider);
+    attach(peakQualitySliderAttachment, "Peak Quality", peakQualitySlider);
+    attach(lowCutFreqSliderAttachment, "LowCut Freq", lowCutFreqSlider);
+    attach(highCutFreqSliderAttachment, "HighCut Freq", highCutFreqSlider);
+    attach(lowCutSlopeSliderAttachment, "LowCut Slope", lowCutSlopeSlider);
+    attach(highCutSlopeSliderAttachment, "HighCut Slope", highCutSlopeSlider);
+}
+
+void _3BandEQAudioProcessorEditor::updateParameterSetButtons()
+{
+    //linked stereo only uses the first set, so the sliders go back to it
+    const bool linked = stereoModeBox.getSelectedItemIndex() <= 0;
+    firstSetButton.setEnabled(! linked);
+    secondSetButton.setEnabled(! linked);
+    if(linked && editedParameterSet != 0)
+    {
+        firstSetButton.setToggleState(true, juce::dontSendNotification);
+        attachSliders(0);
+    }
+}
+
 void _3BandEQAudioProcessorEditor::setupSlider(juce::Slider& slider, juce::Label& label, juce::String valueSuffix, juce::String text, bool onLeft)
 {
     slider.setTextValueSuffix(valueSuffix);
     label.setText(text, juce::dontSendNotification);
     label.attachToComponent (&slider, onLeft);
 }
+
+void _3BandEQAudioProcessorEditor::showMidiLearnMenu()
+{
+    const auto& midiLearn = audioProcessor.getMidiLearn();
+    const auto& parameters = audioProcessor.getParameters();
+
+    //item IDs: 1 + 2 * index learns the parameter, 2 + 2 * index clears it
+    const int clearAllID = 2 * parameters.size() + 1;
+    juce::PopupMenu menu;
+
+    for( int index = 0; index < parameters.size(); ++index )
+    {
+        auto* parameter = parameters[index];
+        if( ! parameter->isAutomatable() )
+            continue;
+
+        const int controller = midiLearn.getController(index);
+        const bool learning = midiLearn.getLearningParameter() == index;
+
+        juce::PopupMenu parameterMenu;
+        parameterMenu.addItem(1 + 2 * index, learning ? "Waiting for a controller..." : "Learn", true, learning);
+        parameterMenu.addItem(2 + 2 * index, "Clear", controller >= 0);
+
+        auto name = parameter->getName(64);
+        if( controller >= 0 )
+            name << " (CC " << controller << ")";
+        menu.addSubMenu(name, parameterMenu, true, nullptr, learning);
+    }
+
+    menu.addSeparator();
+    menu.addItem(clearAllID, "Clear All");
+
+    juce::Component::SafePointer<_3BandEQAudioProcessorEditor> safeThis(this);
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(&midiLearnButton), [safeThis, clearAllID](int result)
+    {
+        if( safeThis == nullptr || result <= 0 )
+            return;
+
+        auto& processor = safeThis->audioProcessor;
+        if( result == clearAllID )
+        {
+            processor.clearMidiLearn(-1);
+        }
+        else if( result % 2 == 1 )
+        {
+            //choosing the armed parameter again cancels learning
+            const int index = (result - 1) / 2;
+            if( processor.getMidiLearn().getLearningParameter() == index )
+                processor.stopMidiLearn();
+            else
+                processor.startMidiLearn(index);
+        }
+        else
+        {
+            processor.clearMidiLearn((result - 2) / 2);
+        }
+
+        safeThis->changeListenerCallback(nullptr);
+    });
+}
+
+void _3BandEQAudioProcessorEditor::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    //the button shows that a parameter waits for its controller
+    const bool learning = audioProcessor.getMidiLearn().getLearningParameter() >= 0;
+    midiLearnButton.setButtonText(learning ? "Learning..." : "MIDI...");
+}
+
+void _3BandEQAudioProcessorEditor::chooseMatchFiles()
+{
+    const auto flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles;
+    const juce::String wildcard = "*.wav;*.aif;*.aiff;*.flac;*.ogg";
+
+    //first the material that will run through the plugin, then the reference it should sound like
+    sourceChooser = std::make_unique<juce::FileChooser>("Choose the source (the material to be processed)", juce::File(), wildcard);
+    sourceChooser->launchAsync(flags, [this, flags, wildcard](const juce::FileChooser& chooser)
+    {
+        const auto source = chooser.getResult();
+        if( source == juce::File() )
+            return;
+
+        referenceChooser = std::make_unique<juce::FileChooser>("Choose the reference", source.getParentDirectory(), wildcard);
+        referenceChooser->launchAsync(flags, [this, source](const juce::FileChooser& referenceResult)
+        {
+            const auto reference = referenceResult.getResult();
+            if( reference != juce::File() )
+                startMatch(source, reference);
+        });
+    });
+}
+
+//analyzes both files and fits the settings, hands the result to the editor on the message thread
+class _3BandEQAudioProcessorEditor::MatchJob : public juce::ThreadPoolJob
+{
+public:
+    MatchJob(_3BandEQAudioProcessorEditor* editor, juce::ThreadPool& analysisPool, const juce::File& source,
+             const juce::File& reference, double sampleRate)
+        : juce::ThreadPoolJob("Match"), editor(editor), analysisPool(analysisPool),
+          source(source), reference(reference), sampleRate(sampleRate)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        AverageSpectrum sourceSpectrum, referenceSpectrum;
+        SpectrumMatcher::Match match;
+        auto stop = [this] { return shouldExit(); };
+
+        auto result = SpectrumMatcher::analyzeFile(source, analysisPool, sourceSpectrum, stop);
+        if( result.wasOk() )
+            result = SpectrumMatcher::analyzeFile(reference, analysisPool, referenceSpectrum, stop);
+        if( result.wasOk() )
+            match = SpectrumMatcher::fit(sourceSpectrum, referenceSpectrum, sampleRate);
+
+        //stopped because the editor is closing, there's nobody left to tell
+        if( shouldExit() )
+            return jobHasFinished;
+
+        auto safeEditor = editor;
+        juce::MessageManager::callAsync([safeEditor, result, match]
+        {
+            if( safeEditor != nullptr )
+                safeEditor->finishMatch(result, match);
+        });
+        return jobHasFinished;
+    }
+
+private:
+    juce::Component::SafePointer<_3BandEQAudioProcessorEditor> editor;
+    juce::ThreadPool& analysisPool;
+    const juce::File source, reference;
+    const double sampleRate;
+};
+
+void _3BandEQAudioProcessorEditor::startMatch(const juce::File& source, const juce::File& reference)
+{
+    matchButton.setEnabled(false);
+    matchButton.setButtonText("Matching...");
+
+    //designed for the rate the plugin runs at, 48 kHz before it was prepared
+    const auto sampleRate = audioProcessor.getSampleRate() > 0.0 ? audioProcessor.getSampleRate() : 48000.0;
+
+    if( analysisPool == nullptr )
+        analysisPool = std::make_unique<juce::ThreadPool>(juce::SystemStats::getNumCpus());
+
+    matchPool.addJob(new MatchJob(this, *analysisPool, source, reference, sampleRate), true);
+}
+
+void _3BandEQAudioProcessorEditor::finishMatch(const juce::Result& result, const SpectrumMatcher::Match& match)
+{
+    matchButton.setEnabled(true);
+    matchButton.setButtonText("Match...");
+
+    if( result.failed() )
+    {
+        juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Match", result.getErrorMessage());
+        return;
+    }
+
+    audioProcessor.setChainSettings(match.settings);
+}
@@ -10,6 +10,8 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "SpectrumMatcher.h"
+#include "PresetLibrary.h"
 
 //==============================================================================
 /**
@@ -34,11 +36,20 @@ struct CustomLinearVSlider : juce::Slider
 };
 
 //===============================ResponseCurveComponent===============================================
+//one worker thread renders the response curves of all editors in the process
+struct CurveRenderPool
+{
+  juce::ThreadPool pool {1};
+};
+
 //response curve gets its own component so painter can't draw out of bounds
 //this is very similar to the _3BandEQAudioProcessorEditor
+//the curve is rendered into a path on the shared worker whenever a parameter or the sample rate changes,
+//paint only draws the latest finished path, nothing runs while the editor is idle or hidden
 struct ResponseCurveComponent: juce::Component,
 juce::AudioProcessorParameter::Listener,
-juce::Timer
+juce::ChangeListener,
+juce::AsyncUpdater
 {
   ResponseCurveComponent(_3BandEQAudioProcessor&);
   ~ResponseCurveComponent();
@@ -48,17 +59,56 @@ juce::Timer
   //empty implementation for this function, because we don't use parameterGestures
   void parameterGestureChanged (int parameterIndex, bool gestureIsStarting) override {}
 
-  void timerCallback() override;
+  //the processor was prepared with another sample rate
+  void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+  //a parameter changed or a new curve is ready
+  void handleAsyncUpdate() override;
 
   void paint(juce::Graphics& g) override;
   void resized() override;
+  void visibilityChanged() override;
+  void parentHierarchyChanged() override;
 private:
   _3BandEQAudioProcessor& audioProcessor;
-  juce::Atomic<bool> parametersChanged{true};
 
-  MonoChain monoChain;
+  //the parameters the curve is drawn from (the chain settings of both sets and the stereo mode)
+  juce::Array<juce::AudioProcessorParameter*> curveParameters;
+  //chain parameter set of every parameter index, -1 for the ones that aren't listened to
+  std::vector<int> parameterSets;
+  std::atomic<float>* stereoMode = nullptr;
+  //set by the parameter callbacks (any thread, the audio thread included), the render job is queued on the message thread
+  std::atomic<bool> parametersOutdated {false};
+  //set by the render job when it swapped in a new curve
+  std::atomic<bool> curveReady {false};
+
+  //the curves' coefficient sets, shared with every other open editor (the processor designs its cascades in place)
+  juce::SharedResourcePointer<CoefficientCache> coefficientCache;
 
+  //grid and labels, drawn the first time they're painted at a new size
   juce::Image background;
+  void drawBackground();
+
+  //cos(w) and cos(2w) of the frequency of every pixel, recomputed when the width or sample rate changes
+  //(only touched by the render job)
+  std::vector<double> cosW, cos2W;
+  double gridSampleRate = 0.0;
+
+  juce::SharedResourcePointer<CurveRenderPool> renderPool;
+  //guards everything below, shared between the message thread and the render job
+  juce::CriticalSection renderLock;
+  bool curveOutdated = true, renderJobQueued = false, showing = false;
+  juce::Rectangle<int> curveArea;
+  //the first parameter set's curve (both channels, left or mid), and the second set's (right or side) unless linked
+  juce::Path responseCurves[2];
+  StereoMode curveMode = StereoMode::Linked;
+  //signalled while no render job is queued or running
+  juce::WaitableEvent renderIdle {true};
+
+  //mark the curve outdated and queue a render job unless one is pending or the component isn't showing (message thread)
+  void requestCurve();
+  void renderCurves();
+  juce::Path renderCurve(juce::Rectangle<int> area, double sampleRate, const ChainSettings& chainSettings);
+  void updateShowing();
 
   juce::Rectangle<int> getRenderArea();
 
@@ -66,8 +116,47 @@ private:
 };
 
 
+//===============================PresetBrowser===============================================
+//list of all presets in the library with a thumbnail of their response, opened from the editor
+//only the index is read while browsing, a preset's full state is loaded when it's selected
+class PresetBrowser : public juce::Component,
+                      private juce::ListBoxModel,
+                      private juce::ChangeListener
+{
+public:
+  PresetBrowser(_3BandEQAudioProcessor&);
+  ~PresetBrowser() override;
+
+  void resized() override;
+
+private:
+  int getNumRows() override;
+  void paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+  void selectedRowsChanged(int lastRowSelected) override;
+  //the check of the folder changed the presets
+  void changeListenerCallback(juce::ChangeBroadcaster*) override;
+
+  //show only presets whose name or tags contain the search text
+  void updateFilter();
+  //ask for name and tags and store the current state
+  void saveCurrentState();
+
+  _3BandEQAudioProcessor& audioProcessor;
+  juce::SharedResourcePointer<PresetLibrary> library;
+  //indices into the library of the rows shown
+  std::vector<int> rows;
+
+  juce::TextEditor searchBox;
+  juce::ListBox list;
+  juce::TextButton saveButton {"Save..."};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetBrowser)
+};
+
+
 //===================================_3BandEQAudioProcessorEditor===========================================
-class _3BandEQAudioProcessorEditor  : public juce::AudioProcessorEditor
+class _3BandEQAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                      private juce::ChangeListener
 {
 public:
     _3BandEQAudioProcessorEditor (_3BandEQAudioProcessor&);
@@ -106,13 +195,61 @@ private:
     using APVTS = juce::AudioProcessorValueTreeState;
     using Attachment = APVTS::SliderAttachment;
 
-    Attachment peakFreqSliderAttachment,
+    //recreated whenever the sliders switch to the other parameter set
+    std::unique_ptr<Attachment> peakFreqSliderAttachment,
     peakGainSliderAttachment,
     peakQualitySliderAttachment,
     lowCutFreqSliderAttachment,
     highCutFreqSliderAttachment,
     lowCutSlopeSliderAttachment,
     highCutSlopeSliderAttachment;
+    //attach the sliders to the parameters of one set
+    void attachSliders(int parameterSet);
+
+    //loudness compensation switch
+    juce::ToggleButton autoGainButton {"Auto Gain"};
+    juce::AudioProcessorValueTreeState::ButtonAttachment autoGainButtonAttachment;
+
+    //crossover split switch (the bands go to the plugin's extra outputs)
+    juce::ToggleButton crossoverButton {"Crossover"};
+    juce::AudioProcessorValueTreeState::ButtonAttachment crossoverButtonAttachment;
+
+    //linked, dual mono or mid/side
+    juce::ComboBox stereoModeBox;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> stereoModeAttachment;
+    //parameter set the sliders edit: left or mid, right or side (only the first one while linked)
+    juce::ToggleButton firstSetButton {"L/M"}, secondSetButton {"R/S"};
+    int editedParameterSet = 0;
+    void updateParameterSetButtons();
+
+    //opens the preset browser
+    juce::TextButton presetsButton {"Presets..."};
+    //keeps the index in memory while the editor is open, so a browser doesn't read it again every time it opens
+    juce::SharedResourcePointer<PresetLibrary> presetLibrary;
+
+    //MIDI learn: every automatable parameter can be armed for the next controller, or lose its controller
+    juce::TextButton midiLearnButton {"MIDI..."};
+    void showMidiLearnMenu();
+    //a controller was learned or removed
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+    //quality governor switch and the tier it's currently at
+    juce::ToggleButton governorButton {"Governor"};
+    juce::AudioProcessorValueTreeState::ButtonAttachment governorButtonAttachment;
+    juce::Label qualityTierLabel;
+    std::unique_ptr<juce::ParameterAttachment> qualityTierAttachment;
+
+    //reference matching: pick a source and a reference file, the fitted settings are applied to the parameters
+    juce::TextButton matchButton {"Match..."};
+    std::unique_ptr<juce::FileChooser> sourceChooser, referenceChooser;
+    //the frames of both files are spread over all cores, created with the first match and kept for the next ones
+    std::unique_ptr<juce::ThreadPool> analysisPool;
+    //runs the match, which is stopped and waited for when the editor closes (declared after analysisPool, so it goes first)
+    juce::ThreadPool matchPool {1};
+    class MatchJob;
+    void chooseMatchFiles();
+    void startMatch(const juce::File& source, const juce::File& reference);
+    void finishMatch(const juce::Result& result, const SpectrumMatcher::Match& match);
 
     //helper function to get Components as vector
     std::vector<juce::Component*> getComps();
@@ -8,6 +8,48 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "CoefficientCache.h"
+
+//parameter IDs of both parameter sets, literals so nothing is allocated on the audio thread
+static const char* const chainParameterIDs[2][7] =
+{
+    { "LowCut Freq", "HighCut Freq", "Peak Freq", "Peak Gain", "Peak Quality", "LowCut Slope", "HighCut Slope" },
+    { "LowCut Freq 2", "HighCut Freq 2", "Peak Freq 2", "Peak Gain 2", "Peak Quality 2", "LowCut Slope 2", "HighCut Slope 2" }
+};
+
+//chain settings from the raw values of one parameter set (in the order of the IDs above)
+static ChainSettings getChainSettings(std::atomic<float>* const* values)
+{
+    ChainSettings settings;
+
+    settings.lowCutFreq = values[0]->load();
+    settings.highCutFreq = values[1]->load();
+    settings.peakFreq = values[2]->load();
+    settings.peakGainInDecibels = values[3]->load();
+    settings.peakQuality = values[4]->load();
+    settings.lowCutSlope = static_cast<Slope>(values[5]->load());
+    settings.highCutSlope = static_cast<Slope>(values[6]->load());
+
+    return settings;
+}
+
+//ranges and choices of the parameters, built once and shared by all instances (sessions can hold hundreds of them)
+struct ParameterMetadata
+{
+    //skew value of 0.25 distributes the values unevenly over the range from 20 to 20000
+    juce::NormalisableRange<float> frequencyRange { 20.f, 20000.f, 1.f, 0.25f };
+    juce::NormalisableRange<float> gainRange { -24.f, 24.f, 0.5f, 1.f };
+    juce::NormalisableRange<float> qualityRange { 0.1f, 10.f, 0.05f, 1.f };
+    //choices for filter cut slope in dB per Octave are always multiples of 12
+    juce::StringArray slopeChoices { "12", "24", "36", "48" };
+    juce::StringArray stereoModeChoices { "Linked", "Dual Mono", "Mid/Side" };
+};
+
+static const ParameterMetadata& getParameterMetadata()
+{
+    static const ParameterMetadata metadata;
+    return metadata;
+}
 
 //==============================================================================
 _3BandEQAudioProcessor::_3BandEQAudioProcessor()
@@ -18,14 +60,44 @@ _3BandEQAudioProcessor::_3BandEQAudioProcessor()
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                       //bands of the crossover split, the main output carries the low band
+                       .withOutput ("Mid",    juce::AudioChannelSet::stereo(), false)
+                       .withOutput ("High",   juce::AudioChannelSet::stereo(), false)
                      #endif
                        )
 #endif
 {
+    for(int set = 0; set < 2; ++set)
+        for(int i = 0; i < numChainParameters; ++i)
+            chainParameters[set][i] = apvts.getRawParameterValue(chainParameterIDs[set][i]);
+
+    crossoverParameter = apvts.getRawParameterValue("Crossover");
+    autoGainParameter = apvts.getRawParameterValue("Auto Gain");
+    stereoModeParameter = apvts.getRawParameterValue("Stereo Mode");
+    governorParameter = apvts.getRawParameterValue("Governor");
+
+    const auto& parameters = getParameters();
+    controllerValuesForHost = std::make_unique<std::atomic<float>[]>(size_t(parameters.size()));
+    for(auto* parameter : parameters)
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+        controllerTargets.push_back(ranged);
+        controllerRawValues.push_back(ranged != nullptr ? apvts.getRawParameterValue(ranged->paramID) : nullptr);
+        controllerValuesForHost[size_t(parameter->getParameterIndex())] = -1.f;
+    }
+
+    //every parameter but the reported tier (which the processor sets itself) is a change event
+    for(auto* parameter : getParameters())
+        if(auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter))
+            if(withID->paramID != "Quality Tier")
+                apvts.addParameterListener(withID->paramID, this);
 }
 
 _3BandEQAudioProcessor::~_3BandEQAudioProcessor()
 {
+    for(auto* parameter : getParameters())
+        if(auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter))
+            apvts.removeParameterListener(withID->paramID, this);
 }
 
 //==============================================================================
@@ -96,19 +168,122 @@ void _3BandEQAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
 
-    juce::dsp::ProcessSpec spec;
+    //hosts prepare again on transport changes and device resets, mostly with the spec they used before,
+    //so only what depends on a changed value is set up again (and the filter states are kept, reset() clears them)
+    const int numChannels = getTotalNumOutputChannels();
+    const bool sampleRateChanged = sampleRate != preparedSampleRate;
+    const bool blockSizeChanged = samplesPerBlock != preparedBlockSize;
+    const bool channelsChanged = numChannels != preparedNumChannels;
 
-    spec.maximumBlockSize = samplesPerBlock;
+    //the first block starts with the modes and filters of the current parameters
+    parametersChanged = false;
+    readModes();
 
-    spec.numChannels = 1;
+    //states that belong to another rate or channel layout don't continue anything
+    if(sampleRateChanged || channelsChanged)
+        reset();
 
-    spec.sampleRate = sampleRate;
+    //execution of the cascades, by default picked per block from its length
+    const auto execution = static_cast<DspKernels::Execution>(static_cast<int>(
+        apvts.state.getProperty("CascadeExecution", static_cast<int>(DspKernels::Execution::Automatic))));
+    leftChain.setExecution(execution);
+    rightChain.setExecution(execution);
 
-    //prepare both mono chains with the spec
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
-    
+    //before the filters are updated, they pass their response on to it (its weighting and meters depend on rate and channels)
+    if(sampleRateChanged || channelsChanged)
+        loudnessCompensator.prepare(sampleRate, numChannels);
+
+    //start building the cut filter tables in the background, until they're ready the filters are designed directly
+    if(apvts.state.getProperty("UseCoefficientTables", false))
+    {
+        const int tableResolution = apvts.state.getProperty("CoefficientTableResolution", CutFilterTables::fullResolution);
+        //the table of the old rate is let go first, so it's dropped unless other instances still run at that rate
+        activeTable = nullptr;
+        activeTable = cutFilterTables->prepare(sampleRate, tableResolution);
+    }
+    else
+    {
+        activeTable = nullptr;
+    }
+
+    //every run starts with the full cut slopes, like the governor starts at full quality
+    cutSlopeLimit = Slope::Slope_48;
+    //designed only if the settings or the sample rate changed (nothing at all for the same spec and parameters)
     updateFilters();
+
+    //listeners are told after the filters were redesigned for the new rate
+    if(sampleRateChanged)
+        sampleRateChanges.sendChangeMessage();
+
+    //the governor starts every run at full quality
+    governor.prepare(sampleRate);
+    blocksUntilUpdate = 0;
+    triggerAsyncUpdate();
+
+    //cut filter realization for the realtime path, the parallel sections start from silence when they take over
+    const bool parallel = static_cast<int>(apvts.state.getProperty("CutFilterRealization", static_cast<int>(CutFilterRealization::Cascade)))
+                          == CutFilterRealization::ParallelSections;
+    if(parallel && ! useParallelCutFilters)
+    {
+        for(auto& filter : lowCutParallel)
+            filter.reset();
+        for(auto& filter : highCutParallel)
+            filter.reset();
+    }
+    useParallelCutFilters = parallel;
+
+    //the lane engine for the dual mono and mid/side modes (one stereo stream)
+    //its blocks depend on the block size, its lanes on the rate, they're designed with the first block that uses them
+    if(laneEngine == nullptr || blockSizeChanged)
+        laneEngine = std::make_unique<EQEngine>(sampleRate, samplesPerBlock, std::vector<int> { 2 });
+    else if(sampleRateChanged)
+        laneEngine->setSampleRate(sampleRate);
+    if(blockSizeChanged || sampleRateChanged)
+        for(auto& settings : laneSettings)
+            settings = ChainSettings();
+    laneEngine->setMidSide(0, stereoMode == StereoMode::MidSide);
+    lanesOutdated = true;
+
+    //offline bounces can afford the double precision, smoothed engine, live playback uses the lean chains
+    //(the engine is only created once the host renders offline)
+    const bool offline = isNonRealtime();
+    if(offline)
+    {
+        if(offlineEngine == nullptr)
+            offlineEngine = std::make_unique<OfflineEngine>();
+        if(! renderOffline || sampleRateChanged || blockSizeChanged)
+            offlineEngine->prepare(sampleRate, samplesPerBlock, readChainSettings(0));
+        else
+            //a render with the same spec starts from silence as well, not from the last one's tail and ramps
+            offlineEngine->reset(readChainSettings(0));
+    }
+    renderOffline = offline;
+
+    preparedSampleRate = sampleRate;
+    preparedBlockSize = samplesPerBlock;
+    preparedNumChannels = numChannels;
+
+    //neither tier adds latency, reporting the same value for both keeps bounces aligned with playback
+    setLatencySamples(0);
+}
+
+void _3BandEQAudioProcessor::reset()
+{
+    //start all filters from silence
+    leftChain.reset();
+    rightChain.reset();
+    for(auto& filter : lowCutParallel)
+        filter.reset();
+    for(auto& filter : highCutParallel)
+        filter.reset();
+    for(auto& crossover : crossovers)
+        crossover.reset();
+    if(laneEngine != nullptr)
+        laneEngine->reset();
+    //the smoothers jump to the current settings, so a bounce doesn't ramp from where the last one ended
+    if(offlineEngine != nullptr)
+        offlineEngine->reset(readChainSettings(0));
+    loudnessCompensator.reset();
 }
 
 void _3BandEQAudioProcessor::releaseResources()
@@ -138,6 +313,12 @@ bool _3BandEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
         return false;
    #endif
 
+    //the band outputs are either off or have the channels of the main output
+    for (int bus = 1; bus < layouts.outputBuses.size(); ++bus)
+        if (! layouts.outputBuses[bus].isDisabled()
+         && layouts.outputBuses[bus] != layouts.getMainOutputChannelSet())
+            return false;
+
     return true;
   #endif
 }
@@ -145,6 +326,7 @@ bool _3BandEQAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 
 void _3BandEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    //the denormal flags belong to the calling thread, so this one stays per block
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -158,24 +340,288 @@ void _3BandEQAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    //---------update filters before running audio through the chain
-    updateFilters();
+    //---------with static parameters nothing is read or designed, the block only runs the filters
+    if(parametersChanged.exchange(false))
+    {
+        readModes();
+        filtersOutdated = lanesOutdated = true;
+    }
+
+    //without MIDI the whole block is one piece, no controller has to be looked at
+    if(midiMessages.isEmpty())
+    {
+        processSubBlock(buffer, false);
+        return;
+    }
+
+    //---------learned controllers set their parameters where they arrive, the block is split there
+    //so the filters follow within the block
+    const auto numSamples = buffer.getNumSamples();
+    int start = 0;
+    bool mappingChanged = false, controllersApplied = false;
+    //a controller was applied since the last piece (also before the first one when it arrived in its first samples)
+    bool pieceHasController = false;
+
+    auto processUpTo = [&](int end)
+    {
+        if(end <= start)
+            return;
+
+        //refers to the channels of the block, nothing is allocated
+        juce::AudioBuffer<float> subBlock(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, end - start);
+        processSubBlock(subBlock, pieceHasController);
+        pieceHasController = false;
+        start = end;
+    };
+
+    for(const auto metadata : midiMessages)
+    {
+        const auto message = metadata.getMessage();
+        if(! message.isController())
+            continue;
+
+        const int parameterIndex = midiLearn.handleController(message.getControllerNumber(), mappingChanged);
+        if(parameterIndex < 0 || parameterIndex >= int(controllerTargets.size()))
+            continue;
+
+        auto* parameter = controllerTargets[size_t(parameterIndex)];
+        auto* rawValue = controllerRawValues[size_t(parameterIndex)];
+        if(parameter == nullptr || rawValue == nullptr)
+            continue;
+
+        //a controller closer than minSubBlockSize to the last split point takes effect at that point
+        const int position = juce::jlimit(0, numSamples, metadata.samplePosition);
+        if(position - start >= minSubBlockSize)
+            processUpTo(position);
+
+        //the filters read the raw value, so it's all the next piece needs, nothing here locks or allocates
+        //(setValueNotifyingHost would call into the host and all listeners from the audio thread)
+        const float value = float(message.getControllerValue()) / 127.f;
+        const auto& range = parameter->getNormalisableRange();
+        rawValue->store(range.snapToLegalValue(range.convertFrom0to1(value)));
+        controllerValuesForHost[size_t(parameterIndex)] = value;
+        controllersApplied = pieceHasController = true;
+    }
+
+    processUpTo(numSamples);
+
+    if(mappingChanged)
+        midiLearnChanged = true;
+    if(mappingChanged || controllersApplied)
+        triggerAsyncUpdate();
+}
+
+void _3BandEQAudioProcessor::processSubBlock(juce::AudioBuffer<float>& buffer, bool splitPoint)
+{
+    auto totalNumInputChannels  = getTotalNumInputChannels();
+
+    //a controller may have switched a mode
+    if(splitPoint)
+        readModes();
+
+    //dual mono and mid/side run one pass for both channels (with a parameter set each)
+    const bool lanes = stereoMode != StereoMode::Linked && laneEngine != nullptr && totalNumInputChannels >= 2;
+
+    //the governor's cheapest tier shortens the cut filters of the realtime chain, every other path runs them in full
+    const bool realtimeChain = ! crossoverEnabled && ! lanes && ! renderOffline;
+    const auto slopeLimit = realtimeChain && governorEnabled && governor.getTier() >= QualityGovernor::ReducedCutSlopes
+                            ? reducedCutSlope : Slope::Slope_48;
+    const bool slopeLimitChanged = slopeLimit != cutSlopeLimit;
+    if(slopeLimitChanged)
+    {
+        cutSlopeLimit = slopeLimit;
+        filtersOutdated = true;
+    }
+
+    //at block boundaries only after a parameter changed, at split points a controller just set one
+    auto update = [this, splitPoint]
+    {
+        if(splitPoint || filtersOutdated)
+            updateFilters();
+    };
+
+    //---------crossover split, bypasses the chain (and the auto gain, the bands sum flat)
+    if(crossoverEnabled)
+    {
+        update();
+        processCrossover(buffer);
+        autoGainActive = false;
+        return;
+    }
+
+    //---------the auto gain meters the input before it's filtered, its prediction covers the parameter sets in use
+    const bool autoGain = autoGainEnabled;
+    if(autoGain)
+        loudnessCompensator.setNumParameterSets(lanes ? 2 : 1);
+    if(autoGain && ! autoGainActive)
+        loudnessCompensator.reset();
+    autoGainActive = autoGain;
+    if(autoGain)
+        loudnessCompensator.measureInput(buffer);
+
+    //---------the lanes run offline too (the offline engine only knows linked stereo)
+    if(lanes)
+    {
+        //keeps the cascades (and the auto gain's prediction of the first parameter set) in step with the parameters
+        update();
+        if(splitPoint || lanesOutdated)
+            updateLaneEngine(stereoMode);
+
+        float* const* streams[] = { buffer.getArrayOfWritePointers() };
+        laneEngine->process(streams, buffer.getNumSamples());
+
+        if(autoGain)
+            loudnessCompensator.process(buffer);
+        return;
+    }
+
+    //---------offline rendering goes through the high quality engine
+    if(renderOffline)
+    {
+        offlineEngine->setTargetSettings(readChainSettings(0));
+        offlineEngine->process(buffer);
+        //keeps the cascades (and the auto gain's prediction) in step with the parameters
+        update();
+        if(autoGain)
+            loudnessCompensator.process(buffer);
+        return;
+    }
+
+    //---------the governor measures the realtime block (or the piece of it) against its budget
+    governor.setEnabled(governorEnabled);
+    governor.blockStarted();
+    const auto tier = governor.getTier();
+
+    //---------update filters before running audio through the chain (only every few blocks under pressure, but always at split points
+    //and when the cut slopes are limited or restored)
+    if(splitPoint || slopeLimitChanged || tier < QualityGovernor::ReducedUpdateRate || --blocksUntilUpdate <= 0)
+    {
+        update();
+        blocksUntilUpdate = reducedUpdateInterval;
+    }
+
+    //under more pressure, the peak filter is skipped while it does nothing at all (0 dB and rung out),
+    //the cut filters are never neutral, even at the ends of their ranges they still cut
+    bool leftPeak = true, rightPeak = true;
+    if(tier >= QualityGovernor::NeutralStageElision)
+    {
+        leftPeak = ! leftChain.isPeakNeutral();
+        rightPeak = ! rightChain.isPeakNeutral();
+    }
 
     //----------run audio through the chain
-    //make AudioBlock from buffer
-    juce::dsp::AudioBlock<float> block(buffer);
+    const auto numSamples = buffer.getNumSamples();
     //get left channel
-    auto leftBlock = block.getSingleChannelBlock(0);
+    auto* left = buffer.getWritePointer(0);
     //get right channel
-    auto rightBlock = block.getSingleChannelBlock(1);
+    auto* right = buffer.getWritePointer(1);
 
-    //context is sort of a wrapper around the block that the chain can use
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+    //cut filters realized as parallel sections, the peak filter of the chain stays a single biquad
+    if(useParallelCutFilters)
+    {
+        lowCutParallel[0].process(left, numSamples);
+        lowCutParallel[1].process(right, numSamples);
+        if(leftPeak)
+            leftChain.processPeak(left, numSamples);
+        if(rightPeak)
+            rightChain.processPeak(right, numSamples);
+        highCutParallel[0].process(left, numSamples);
+        highCutParallel[1].process(right, numSamples);
+    }
+    else
+    {
+        //the channels can then be passed to the mono filter chains to be processed
+        leftChain.process(left, numSamples, true, leftPeak, true);
+        rightChain.process(right, numSamples, true, rightPeak, true);
+    }
 
-    //these contexts can then be passed to the mono filter chains to be processed
-    leftChain.process(leftContext);
-    rightChain.process(rightContext);
+    //---------match the output loudness to the input
+    if(autoGain)
+        loudnessCompensator.process(buffer);
+
+    if(governor.blockFinished(numSamples))
+        triggerAsyncUpdate();
+}
+
+void _3BandEQAudioProcessor::processCrossover(juce::AudioBuffer<float>& buffer)
+{
+    //the main bus carries the input in and the low band out
+    auto mainBuffer = getBusBuffer(buffer, false, 0);
+    const auto numSamples = buffer.getNumSamples();
+    const int numChannels = juce::jmin(mainBuffer.getNumChannels(), 2);
+
+    //channel of a band output, nullptr when the host turned that bus off
+    auto getBandChannel = [this, &buffer](int bus, int channel) -> float*
+    {
+        auto* outputBus = getBus(false, bus);
+        if(outputBus == nullptr || ! outputBus->isEnabled() || channel >= outputBus->getNumberOfChannels())
+            return nullptr;
+        return buffer.getWritePointer(outputBus->getChannelIndexInProcessBlockBuffer(channel));
+    };
+
+    for(int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* data = mainBuffer.getWritePointer(ch);
+        auto& chain = ch == 0 ? leftChain : rightChain;
+
+        //the peak filter shapes the input before it's split, so it's heard in all bands
+        chain.processPeak(data, numSamples);
+        crossovers[ch].process(data, data, getBandChannel(1, ch), getBandChannel(2, ch), numSamples);
+    }
+}
+
+void _3BandEQAudioProcessor::parameterChanged(const juce::String&, float)
+{
+    parametersChanged = true;
+}
+
+void _3BandEQAudioProcessor::readModes()
+{
+    crossoverEnabled = crossoverParameter->load() > 0.5f;
+    autoGainEnabled = autoGainParameter->load() > 0.5f;
+    governorEnabled = governorParameter->load() > 0.5f;
+
+    //the chains and the lanes hold the state of the other mode's signals (e.g. mid and side instead of left and right),
+    //carried over it would ring out through the wrong channels, so the filters start from silence
+    const auto newStereoMode = static_cast<StereoMode>(int(stereoModeParameter->load()));
+    if(newStereoMode != stereoMode)
+    {
+        leftChain.reset();
+        rightChain.reset();
+        for(auto& filter : lowCutParallel)
+            filter.reset();
+        for(auto& filter : highCutParallel)
+            filter.reset();
+        if(laneEngine != nullptr)
+            laneEngine->reset();
+        stereoMode = newStereoMode;
+    }
+}
+
+void _3BandEQAudioProcessor::handleAsyncUpdate()
+{
+    //set on the message thread, so hosts and the editor see the tier like any other parameter change
+    //(only when it changed, the update is also triggered for the MIDI controllers)
+    auto* parameter = apvts.getParameter("Quality Tier");
+    const float tier = parameter->convertTo0to1(float(governor.getTier()));
+    if(parameter->getValue() != tier)
+        parameter->setValueNotifyingHost(tier);
+
+    //controller values the audio thread has already applied, the host and the editor hear about them here
+    //(setting them again changes nothing for the audio thread, the raw values are the same)
+    for(auto* parameter : getParameters())
+    {
+        const float value = controllerValuesForHost[size_t(parameter->getParameterIndex())].exchange(-1.f);
+        if(value >= 0.f)
+            parameter->setValueNotifyingHost(value);
+    }
+
+    //a controller was learned on the audio thread
+    if(midiLearnChanged.exchange(false))
+    {
+        storeMidiLearn();
+        midiLearnChanges.sendChangeMessage();
+    }
 }
 
 //==============================================================================
@@ -206,143 +652,370 @@ void _3BandEQAudioProcessor::setStateInformation (const void* data, int sizeInBy
 {
     // You should use this method to restore your parameters from this memory block,
     // whose contents will have been created by the getStateInformation() call.
-    auto tree = juce::ValueTree::readFromData(data, sizeInBytes);
-    if(tree.isValid())
+    loadState(juce::ValueTree::readFromData(data, sizeInBytes));
+}
+
+void _3BandEQAudioProcessor::loadState(const juce::ValueTree& state)
+{
+    if(state.isValid())
+    {
+        apvts.replaceState(state);
+
+        //states without a map (e.g. older sessions) keep the current controllers
+        const auto midiLearnState = state.getChildWithName(MidiLearn::stateType);
+        if(midiLearnState.isValid())
+            midiLearn.loadState(midiLearnState, getParameters());
+        storeMidiLearn();
+        midiLearnChanges.sendChangeMessage();
+
+        //the audio thread designs the filters for the new values before its next block
+        parametersChanged = true;
+    }
+}
+
+juce::ValueTree _3BandEQAudioProcessor::getPresetState()
+{
+    //same tree type as the full state, with only the PARAM children of the chain parameters
+    const auto state = apvts.copyState();
+    juce::ValueTree preset(state.getType());
+    for(const auto& child : state)
+        if(getChainParameterSet(child.getProperty("id").toString()) >= 0)
+            preset.appendChild(child.createCopy(), nullptr);
+
+    return preset;
+}
+
+void _3BandEQAudioProcessor::loadPreset(const juce::ValueTree& preset)
+{
+    if(! preset.isValid())
+        return;
+
+    //the chain parameters of the preset go into a copy of the current state, everything else stays,
+    //presets saved with a full state (before they were stripped) load the same way
+    auto state = apvts.copyState();
+    for(const auto& child : preset)
     {
-        apvts.replaceState(tree);
-        updateFilters();
+        const auto id = child.getProperty("id").toString();
+        if(getChainParameterSet(id) < 0 || ! child.hasProperty("value"))
+            continue;
+
+        auto target = state.getChildWithProperty("id", id);
+        if(target.isValid())
+            target.setProperty("value", child.getProperty("value"), nullptr);
     }
+
+    loadState(state);
 }
 
 //getter function for chain settings
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
+ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts, int parameterSet)
 {
-    ChainSettings settings;
+    std::atomic<float>* values[7];
+    for(int i = 0; i < 7; ++i)
+        values[i] = apvts.getRawParameterValue(chainParameterIDs[parameterSet][i]);
 
-    settings.lowCutFreq = apvts.getRawParameterValue("LowCut Freq")->load();
-    settings.highCutFreq = apvts.getRawParameterValue("HighCut Freq")->load();
-    settings.peakFreq = apvts.getRawParameterValue("Peak Freq")->load();
-    settings.peakGainInDecibels = apvts.getRawParameterValue("Peak Gain")->load();
-    settings.peakQuality = apvts.getRawParameterValue("Peak Quality")->load();
-    settings.lowCutSlope = static_cast<Slope>(apvts.getRawParameterValue("LowCut Slope")->load());
-    settings.highCutSlope = static_cast<Slope>(apvts.getRawParameterValue("HighCut Slope")->load());
+    return getChainSettings(values);
+}
 
-    return settings;
+int getChainParameterSet(const juce::String& parameterID)
+{
+    for(int set = 0; set < 2; ++set)
+        for(auto* id : chainParameterIDs[set])
+            if(parameterID == id)
+                return set;
+
+    return -1;
+}
+
+juce::String getChainParameterID(const juce::String& parameterID, int parameterSet)
+{
+    for(const auto& ids : chainParameterIDs)
+        for(int i = 0; i < 7; ++i)
+            if(parameterID == ids[i])
+                return chainParameterIDs[parameterSet][i];
+
+    jassertfalse;
+    return parameterID;
+}
+
+ChainSettings _3BandEQAudioProcessor::readChainSettings(int parameterSet) const
+{
+    return getChainSettings(chainParameters[parameterSet]);
+}
+
+//update the crossover points
+void _3BandEQAudioProcessor::updateCrossovers(const ChainSettings& chainSettings)
+{
+    //designed in place, nothing is allocated on the audio thread
+    for(auto& crossover : crossovers)
+        crossover.setCrossovers(getSampleRate(),
+                                chainSettings.lowCutFreq, Crossover::getAlignment(chainSettings.lowCutSlope),
+                                chainSettings.highCutFreq, Crossover::getAlignment(chainSettings.highCutSlope));
+}
+//update all the filters
+void _3BandEQAudioProcessor::updateFilters()
+{
+    filtersOutdated = false;
+
+    //get chain Settings, the cut slopes limited by the governor
+    auto chainSettings = readChainSettings(0);
+    chainSettings.lowCutSlope = std::min(chainSettings.lowCutSlope, cutSlopeLimit);
+    chainSettings.highCutSlope = std::min(chainSettings.highCutSlope, cutSlopeLimit);
+    //nothing to do unless the settings (or the sample rate) changed since the last update
+    const bool refresh = getSampleRate() != currentSampleRate;
+    if(! refresh && chainSettings == currentSettings)
+        return;
+
+    const bool cutsChanged = refresh
+                             || chainSettings.lowCutFreq != currentSettings.lowCutFreq || chainSettings.lowCutSlope != currentSettings.lowCutSlope
+                             || chainSettings.highCutFreq != currentSettings.highCutFreq || chainSettings.highCutSlope != currentSettings.highCutSlope;
+
+    //designed straight into the stages on the audio thread: no lock, no allocation, no cache
+    //(the engine has the peak first, then low cut and high cut sections taking turns, unused stages pass through)
+    DspKernels::Biquad stages[EQEngine::maxStages];
+    stages[0] = EQEngine::designPeak(chainSettings, getSampleRate());
+
+    //cut filter sections are fetched from the precomputed tables while they're ready,
+    //only a band the table can't serve (not built yet, frequency off its grid) is designed
+    int numStages = 1;
+    auto setCutFilter = [&](bool lowCut, float freq, Slope slope, int firstSlot)
+    {
+        DspKernels::Biquad sections[4];
+        const auto band = lowCut ? ChainPositions::LowCut : ChainPositions::HighCut;
+        if(activeTable == nullptr || ! activeTable->lookup(band, freq, slope, sections))
+            EQEngine::designCut(lowCut, freq, slope, getSampleRate(), sections);
+
+        for(int i = 0; i <= int(slope); ++i)
+            stages[firstSlot + 2 * i] = sections[i];
+        numStages = juce::jmax(numStages, firstSlot + 2 * int(slope) + 1);
+    };
+    setCutFilter(true, chainSettings.lowCutFreq, chainSettings.lowCutSlope, 1);
+    setCutFilter(false, chainSettings.highCutFreq, chainSettings.highCutSlope, 2);
+
+    //copy the stages into the flat cascades (the order of the stages follows the slopes)
+    leftChain.setCoefficients(stages, chainSettings.lowCutSlope, chainSettings.highCutSlope);
+    rightChain.setCoefficients(stages, chainSettings.lowCutSlope, chainSettings.highCutSlope);
+    loudnessCompensator.setChainResponse(stages, numStages);
+
+    if(cutsChanged)
+    {
+        //keep the parallel realization in sync, so the mode can be switched in prepareToPlay
+        double lowCut[4][5], highCut[4][5];
+        auto copySections = [&stages](double (*sections)[5], int firstSlot, Slope slope)
+        {
+            for(int i = 0; i <= int(slope); ++i)
+            {
+                const auto& stage = stages[firstSlot + 2 * i];
+                const double c[5] = { stage.b0, stage.b1, stage.b2, stage.a1, stage.a2 };
+                std::copy(std::begin(c), std::end(c), sections[i]);
+            }
+        };
+        copySections(lowCut, 1, chainSettings.lowCutSlope);
+        copySections(highCut, 2, chainSettings.highCutSlope);
+
+        for(auto& filter : lowCutParallel)
+            filter.setCoefficients(lowCut, int(chainSettings.lowCutSlope) + 1);
+        for(auto& filter : highCutParallel)
+            filter.setCoefficients(highCut, int(chainSettings.highCutSlope) + 1);
+
+        updateCrossovers(chainSettings);
+    }
+
+    currentSettings = chainSettings;
+    currentSampleRate = getSampleRate();
 }
-//free function to make peak filter coefficients
-Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRate)
+
+void _3BandEQAudioProcessor::updateLaneEngine(StereoMode stereoMode)
 {
-    return juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 
-            chainSettings.peakFreq, 
-            chainSettings.peakQuality, 
-            juce::Decibels::decibelsToGain(chainSettings.peakGainInDecibels));
+    laneEngine->setMidSide(0, stereoMode == StereoMode::MidSide);
+
+    //designed in place, nothing is allocated on the audio thread
+    for(int ch = 0; ch < 2; ++ch)
+    {
+        const auto chainSettings = readChainSettings(ch);
+        if(chainSettings != laneSettings[ch])
+        {
+            laneEngine->setSettings(0, ch, chainSettings);
+            laneSettings[ch] = chainSettings;
+
+            //the first set's response comes from updateFilters, the auto gain needs the second one's as well
+            if(ch == 1)
+            {
+                DspKernels::Biquad stages[EQEngine::maxStages];
+                const int numStages = EQEngine::design(chainSettings, getSampleRate(), stages);
+                loudnessCompensator.setChainResponse(stages, numStages, 1);
+            }
+        }
+    }
+
+    lanesOutdated = false;
 }
 
-//function to update peak filter
-void _3BandEQAudioProcessor::updatePeakFilter(const ChainSettings &chainSettings)
+void _3BandEQAudioProcessor::setChainSettings(const ChainSettings& chainSettings)
 {
-    //get coefficients for peak Filter
-    auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
-    //apply coefficients to filter chain
-    updateCoefficients(leftChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
-    updateCoefficients(rightChain.get<ChainPositions::Peak>().coefficients, peakCoefficients);
+    //every parameter gets its own gesture, so hosts record the change as an automation point
+    auto setParameter = [this](const juce::String& parameterID, float value)
+    {
+        auto* parameter = apvts.getParameter(parameterID);
+        parameter->beginChangeGesture();
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        parameter->endChangeGesture();
+    };
 
+    setParameter("LowCut Freq", chainSettings.lowCutFreq);
+    setParameter("HighCut Freq", chainSettings.highCutFreq);
+    setParameter("Peak Freq", chainSettings.peakFreq);
+    setParameter("Peak Gain", chainSettings.peakGainInDecibels);
+    setParameter("Peak Quality", chainSettings.peakQuality);
+    setParameter("LowCut Slope", float(chainSettings.lowCutSlope));
+    setParameter("HighCut Slope", float(chainSettings.highCutSlope));
+}
+
+void _3BandEQAudioProcessor::setUseCoefficientTables(bool shouldUseTables, int resolution)
+{
+    apvts.state.setProperty("UseCoefficientTables", shouldUseTables, nullptr);
+    apvts.state.setProperty("CoefficientTableResolution", resolution, nullptr);
 }
 
-void updateCoefficients(Coefficients &old, const Coefficients &replacements)
+void _3BandEQAudioProcessor::setCutFilterRealization(CutFilterRealization realization)
 {
-    *old = *replacements;
+    apvts.state.setProperty("CutFilterRealization", static_cast<int>(realization), nullptr);
 }
 
+void _3BandEQAudioProcessor::setCascadeExecution(DspKernels::Execution execution)
+{
+    apvts.state.setProperty("CascadeExecution", static_cast<int>(execution), nullptr);
+}
 
-//update low cut filters
-void _3BandEQAudioProcessor::updateLowCutFilters(const ChainSettings& chainSettings)
+void _3BandEQAudioProcessor::startMidiLearn(int parameterIndex)
 {
-    //get coefficients for low cut filter
-    auto cutCoefficients = makeLowCutFilter(chainSettings, getSampleRate());
+    midiLearn.startLearning(parameterIndex);
+}
 
-    //get left low cut filter chain
-    auto& leftLowCut = leftChain.get<ChainPositions::LowCut>();
-    //get right low cut filter chain
-    auto& rightLowCut = rightChain.get<ChainPositions::LowCut>();
-    //update left lowcut filter chain
-    updateCutFilter(leftLowCut, cutCoefficients, chainSettings.lowCutSlope);
-    //update right lowcut filter chain
-    updateCutFilter(rightLowCut, cutCoefficients, chainSettings.lowCutSlope);
+void _3BandEQAudioProcessor::stopMidiLearn()
+{
+    midiLearn.stopLearning();
 }
-//update high cut filters
-void _3BandEQAudioProcessor::updateHighCutFilters(const ChainSettings& chainSettings)
+
+void _3BandEQAudioProcessor::clearMidiLearn(int parameterIndex)
 {
-    //get coefficients for high cut filter
-    auto cutCoefficients = makeHighCutFilter(chainSettings, getSampleRate());
+    if(parameterIndex < 0)
+        midiLearn.clearAll();
+    else
+        midiLearn.clear(parameterIndex);
 
-    //get left high cut filter chain
-    auto& leftHighCut = leftChain.get<ChainPositions::HighCut>();
-    //get right high cut filter chain
-    auto& rightHighCut = rightChain.get<ChainPositions::HighCut>();
-    //update left high cut filter chain
-    updateCutFilter(leftHighCut, cutCoefficients, chainSettings.highCutSlope);
-    //update right high cut filter chain
-    updateCutFilter(rightHighCut, cutCoefficients, chainSettings.highCutSlope);
+    storeMidiLearn();
+    midiLearnChanges.sendChangeMessage();
 }
-//update all the filters
-void _3BandEQAudioProcessor::updateFilters()
+
+void _3BandEQAudioProcessor::storeMidiLearn()
+{
+    //stored with the parameters, so sessions (and presets) bring their controllers back
+    apvts.state.removeChild(apvts.state.getChildWithName(MidiLearn::stateType), nullptr);
+    apvts.state.appendChild(midiLearn.createState(getParameters()), nullptr);
+}
+
+juce::String _3BandEQAudioProcessor::getMemoryReport() const
 {
-    //get chain Settings
-    auto chainSettings = getChainSettings(apvts);
-    updateLowCutFilters(chainSettings);
-    updatePeakFilter(chainSettings);
-    updateHighCutFilters(chainSettings);
+    //before: two ProcessorChains of 9 IIR filters, every filter with a privately designed coefficients object
+    //and a heap block for its state (at least 4 floats)
+    using BaselineFilter = juce::dsp::IIR::Filter<float>;
+    using BaselineCutFilter = juce::dsp::ProcessorChain<BaselineFilter, BaselineFilter, BaselineFilter, BaselineFilter>;
+    using BaselineChain = juce::dsp::ProcessorChain<BaselineCutFilter, BaselineFilter, BaselineCutFilter>;
+    const auto filtersBefore = 2 * sizeof(BaselineChain)
+                               + 2 * 9 * (CoefficientCache::getCoefficientsMemoryUsage(2) + 4 * sizeof(float));
+    //after: the biquads and their states live in the cascades inside the object, nothing is allocated for them
+    const auto filtersAfter = sizeof(leftChain) + sizeof(rightChain);
+
+    juce::String report;
+    report << "processor object: " << int(sizeof(*this)) << " bytes\n"
+           << "filters before (ProcessorChains, private coefficients): " << int(filtersBefore) << " bytes\n"
+           << "filters after (flat cascades): " << int(filtersAfter) << " bytes\n"
+           << "per instance before: " << int(sizeof(*this) - filtersAfter + filtersBefore) << " bytes\n"
+           << "per instance after: " << int(sizeof(*this)) << " bytes";
+
+    if(activeTable != nullptr)
+        report << "\ncut filter table (shared): " << activeTable->getReport();
+
+    return report;
 }
 
+//integer parameter the plugin reports to the host, but that isn't automatable
+struct ReportedParameterInt : juce::AudioParameterInt
+{
+    using juce::AudioParameterInt::AudioParameterInt;
+    bool isAutomatable() const override { return false; }
+};
+
 juce::AudioProcessorValueTreeState::ParameterLayout _3BandEQAudioProcessor::createParameterLayout()
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
+    const auto& metadata = getParameterMetadata();
 
     //slider (AudioParameterFloat) for low cut frequency, standard: 20 Hz
-    //skew value of 0.25 distributes the values unevenly over the range from 20 to 20000
+    //(skewed, see ParameterMetadata)
     layout.add(std::make_unique<juce::AudioParameterFloat>("LowCut Freq",
             "LowCut Freq",
-            juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f),
+            metadata.frequencyRange,
             20.f));
 
     //slider (AudioParameterFloat) for high cut frequency, standard: 20 kHz
     layout.add(std::make_unique<juce::AudioParameterFloat>("HighCut Freq",
             "HighCut Freq",
-            juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f),
+            metadata.frequencyRange,
             20000.f));
     
     //slider (AudioParameterFloat) for peak frequency, standard: 750 Hz
     layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Freq",
             "Peak Freq",
-            juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f),
+            metadata.frequencyRange,
             750.f));
             
     //slider (AudioParameterFloat) for peak gain, standard: 0 dB
     layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Gain",
             "Peak Gain",
-            juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f),
+            metadata.gainRange,
             0.0f));
             
     //slider (AudioParameterFloat) for peak quality (how narrow or wide the peak is), standard: 1
     layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Quality",
             "Peak Quality",
-            juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f),
+            metadata.qualityRange,
             1.f));
 
-    //choices for filter cut slope in dB per Octave are always multiples of 12
-    juce::StringArray stringArray;
-    for(int i = 0; i<4; ++i)
-    {
-        juce::String str;
-        str << (12 + i*12);
-        stringArray.add(str);
-    }
-
     //choice (AudioParameterChoice) for different low cut slopes
-    layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Slope", "LowCut Slope", stringArray, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Slope", "LowCut Slope", metadata.slopeChoices, 0));
     //choice (AudioParameterChoice) for different high cut slopes
-    layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Slope", "HighCut Slope", stringArray, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Slope", "HighCut Slope", metadata.slopeChoices, 0));
+
+    //switch (AudioParameterBool) for the loudness compensation after the chain, off by default
+    layout.add(std::make_unique<juce::AudioParameterBool>("Auto Gain", "Auto Gain", false));
+
+    //switch (AudioParameterBool) for the crossover split, off by default
+    //when it's on, LowCut Freq and HighCut Freq are the crossover points and the slopes pick the alignment
+    layout.add(std::make_unique<juce::AudioParameterBool>("Crossover", "Crossover", false));
+
+    //switch (AudioParameterBool) for the quality governor, off by default
+    layout.add(std::make_unique<juce::AudioParameterBool>("Governor", "Governor", false));
+    //tier the governor is at, only reported (e.g. for logging), hosts can't automate it
+    layout.add(std::make_unique<ReportedParameterInt>("Quality Tier", "Quality Tier", 0, QualityGovernor::numTiers - 1, 0));
+
+    //choice (AudioParameterChoice) for how the channels are filtered, linked by default
+    layout.add(std::make_unique<juce::AudioParameterChoice>("Stereo Mode", "Stereo Mode", metadata.stereoModeChoices, 0));
+
+    //second parameter set (right or side), same ranges and defaults as the first
+    layout.add(std::make_unique<juce::AudioParameterFloat>("LowCut Freq 2", "LowCut Freq R/S",
+            metadata.frequencyRange, 20.f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("HighCut Freq 2", "HighCut Freq R/S",
+            metadata.frequencyRange, 20000.f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Freq 2", "Peak Freq R/S",
+            metadata.frequencyRange, 750.f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Gain 2", "Peak Gain R/S",
+            metadata.gainRange, 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("Peak Quality 2", "Peak Quality R/S",
+            metadata.qualityRange, 1.f));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("LowCut Slope 2", "LowCut Slope R/S", metadata.slopeChoices, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("HighCut Slope 2", "HighCut Slope R/S", metadata.slopeChoices, 0));
 
 
     return layout;
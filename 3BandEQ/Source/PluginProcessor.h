@@ -9,111 +9,49 @@
 #pragma once
 
 #include <JuceHeader.h>
-
-//Slope setting
-enum Slope
+#include "FilterChain.h"
+#include "CoefficientTables.h"
+#include "OfflineEngine.h"
+#include "ParallelCutFilter.h"
+#include "BiquadCascade.h"
+#include "QualityGovernor.h"
+#include "LoudnessCompensator.h"
+#include "Crossover.h"
+#include "EQEngine.h"
+#include "MidiLearn.h"
+
+//getter function for chain settings
+//parameter set 1 is the second channel's (right or side) in the dual mono and mid/side modes
+ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts, int parameterSet = 0);
+//parameter set (0 or 1) a chain settings parameter belongs to, -1 for all other parameters
+int getChainParameterSet(const juce::String& parameterID);
+//ID of the same chain settings parameter in another parameter set (e.g. "Peak Freq" in set 1 is "Peak Freq 2")
+juce::String getChainParameterID(const juce::String& parameterID, int parameterSet);
+
+//how the realtime path realizes the low cut and high cut filters
+enum CutFilterRealization
 {
-  Slope_12,
-  Slope_24,
-  Slope_36,
-  Slope_48
+  Cascade,
+  ParallelSections
 };
 
-//All Parameters of the Chain
-struct ChainSettings
-{
-  float peakFreq{0}, peakGainInDecibels{0}, peakQuality{1.f};
-  float lowCutFreq{0}, highCutFreq{0};
-  Slope lowCutSlope{Slope::Slope_12}, highCutSlope{Slope::Slope_12};
-};
-//getter function for this struct
-ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
-//Filter with float
-using Filter = juce::dsp::IIR::Filter<float>;
-//CutFilter is 4 filters in a row
-using CutFilter = juce::dsp::ProcessorChain<Filter, Filter, Filter, Filter>;
-//MonoChain is Lowcut, Peak, Highcut in a row
-using MonoChain = juce::dsp::ProcessorChain<CutFilter, Filter, CutFilter>;
-//position of elements in the chain
-enum ChainPositions
+//how the two channels of a stereo bus are filtered
+enum StereoMode
 {
-  LowCut,
-  Peak,
-  HighCut
+  //both channels with the same settings
+  Linked,
+  //left with the first parameter set, right with the second
+  DualMono,
+  //mid with the first parameter set, side with the second
+  MidSide
 };
 
-//declare alias for coefficients
-using Coefficients = Filter::CoefficientsPtr;
-//helper function to update coefficients
-void updateCoefficients(Coefficients& old, const Coefficients& replacements);
-//function to make peak filter coefficients from chainSettings and sampleRate
-Coefficients makePeakFilter(const ChainSettings& chainSettings, double sampleRate);
-
-//helper function to update cut filter coefficients
-template<int Index, typename ChainType, typename CoefficientType>
-void update(ChainType& chain, const CoefficientType& coefficients)
-{
-  updateCoefficients(chain.template get<Index>().coefficients, coefficients[Index]);
-  chain.template setBypassed<Index>(false);
-}
-//template helper function to update cut filters
-template<typename ChainType, typename CoefficientType>
-void updateCutFilter(ChainType& chain,
-    const CoefficientType& coefficients, 
-    const Slope& slope)
-{
-  //bypass all of the links in the chain
-  chain.template setBypassed<0>(true);
-  chain.template setBypassed<1>(true);
-  chain.template setBypassed<2>(true);
-  chain.template setBypassed<3>(true);
-
-  //because the number of coefficients varies based on the filter order, this switch statement is needed
-  switch(slope)
-  {
-      case Slope_48:
-      {
-        update<3>(chain, coefficients);
-      }
-      case Slope_36:
-      {
-        update<2>(chain, coefficients);
-      }
-      case Slope_24:
-      {
-        update<1>(chain, coefficients);
-      }
-      case Slope_12:
-      {
-        update<0>(chain, coefficients);
-      }
-  }
-}
-
-//function to make low cut filter coefficients from chainSettings and sampleRate
-inline auto makeLowCutFilter(const ChainSettings& chainSettings, double sampleRate)
-{
-  //get coefficients for low cut filter
-  //because the filter can be realized with different steepness levels (different orders), the designIIRHighpass... method has to be used
-  //this function returns multiple coefficients for higher order filters (1 coefficient for 2nd order, 2 coefficients for 4th order, ...)
-  return juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.lowCutFreq,
-          sampleRate, 
-          2*(chainSettings.lowCutSlope+1));
-}
-
-//function to make high cut filter coefficients from chainSettings and sampleRate
-inline auto makeHighCutFilter(const ChainSettings& chainSettings, double sampleRate)
-{
-    //get coefficients for high cut filter
-    return juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq,
-            sampleRate, 
-            2*(chainSettings.highCutSlope+1));
-}
-
 //==============================================================================
 /**
 */
-class _3BandEQAudioProcessor  : public juce::AudioProcessor
+class _3BandEQAudioProcessor  : public juce::AudioProcessor,
+                                private juce::AsyncUpdater,
+                                private juce::AudioProcessorValueTreeState::Listener
 {
 public:
     //==============================================================================
@@ -123,6 +61,8 @@ public:
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    //clear the filter states (prepareToPlay keeps them when the spec didn't change)
+    void reset() override;
 
    #ifndef JucePlugin_PreferredChannelConfigurations
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
@@ -153,20 +93,138 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //replace the whole state (from the host), invalid trees are ignored
+    void loadState(const juce::ValueTree& state);
+
+    //presets hold the sound only: the chain parameters of both sets. the modes and routing (auto gain, crossover,
+    //governor, stereo mode), the engine options and the MIDI learn map belong to the session and stay as they are
+    juce::ValueTree getPresetState();
+    void loadPreset(const juce::ValueTree& preset);
+
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     juce::AudioProcessorValueTreeState apvts {*this, nullptr, "Parameters", createParameterLayout()};
 
+    //sends a change message when the processor is prepared with a different sample rate (e.g. for the response curve)
+    juce::ChangeBroadcaster sampleRateChanges;
+
+    //set all band parameters at once and notify the host (e.g. after matching a reference)
+    void setChainSettings(const ChainSettings& chainSettings);
+
+    //report of the memory this instance owns, its filters before and after the flat cascades (and the tables it shares)
+    juce::String getMemoryReport() const;
+
+    //optional mode: cut filter coefficients are fetched from tables precomputed in the background
+    //(stored with the state, takes effect at the next prepareToPlay)
+    void setUseCoefficientTables(bool shouldUseTables, int resolution = CutFilterTables::fullResolution);
+
+    //optional mode: cut filters run as parallel sections in SIMD lanes instead of a cascade
+    //(stored with the state, takes effect at the next prepareToPlay)
+    void setCutFilterRealization(CutFilterRealization realization);
+
+    //optional: how the realtime cascades walk over a block (stored with the state, takes effect at the next prepareToPlay)
+    void setCascadeExecution(DspKernels::Execution execution);
+
+    //MIDI learn (message thread): the next controller that arrives is mapped to the parameter (index in getParameters())
+    void startMidiLearn(int parameterIndex);
+    void stopMidiLearn();
+    //remove the controller of a parameter, -1 removes all of them
+    void clearMidiLearn(int parameterIndex);
+    const MidiLearn& getMidiLearn() const { return midiLearn; }
+    //sends a change message when a controller was learned or removed
+    juce::ChangeBroadcaster midiLearnChanges;
+
 private:
-    //two MonoChains make the Stereo Chain
-    MonoChain leftChain, rightChain;
-    //function to update peak filter
-    void updatePeakFilter(const ChainSettings& chainSettings);
-
-    //update low cut filters
-    void updateLowCutFilters(const ChainSettings& chainSettings);
-    //update high cut filters
-    void updateHighCutFilters(const ChainSettings& chainSettings);
-    //update all the filters
+    //---------per block setup is hoisted out of processBlock: the raw values are looked up by ID once,
+    //and the parameters are only read again after one of them changed
+    static constexpr int numChainParameters = 7;
+    std::atomic<float>* chainParameters[2][numChainParameters] = {};
+    std::atomic<float>* crossoverParameter = nullptr, * autoGainParameter = nullptr,
+                      * stereoModeParameter = nullptr, * governorParameter = nullptr;
+    //raised by the listener after the new value is in place, so a block that takes it down reads the new value
+    std::atomic<bool> parametersChanged{true};
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    //settings of a parameter set from the raw values
+    ChainSettings readChainSettings(int parameterSet) const;
+
+    //the modes as the audio thread last read them
+    bool crossoverEnabled = false, autoGainEnabled = false, governorEnabled = false;
+    StereoMode stereoMode = StereoMode::Linked;
+    void readModes();
+    //the filters (and the lanes) haven't seen the last parameter change yet
+    bool filtersOutdated = true, lanesOutdated = true;
+
+    //spec of the last prepareToPlay
+    double preparedSampleRate = 0.0;
+    int preparedBlockSize = 0, preparedNumChannels = 0;
+
+    //learned controllers split the block where they arrive, but never into pieces shorter than this
+    //(so a dense controller stream costs at most one filter update every minSubBlockSize samples)
+    static constexpr int minSubBlockSize = 32;
+    //the chain for one piece of the block, at a split point the filters are updated in place
+    void processSubBlock(juce::AudioBuffer<float>& buffer, bool splitPoint);
+
+    //controllers mapped to parameters, looked up on the audio thread
+    MidiLearn midiLearn;
+    //set on the audio thread when a controller was learned, the map is stored on the message thread
+    std::atomic<bool> midiLearnChanged{false};
+    //controllers write the raw values of their parameters on the audio thread (looked up by index once),
+    //the host is told on the message thread: the normalised value waiting for that per parameter, -1 when none is
+    std::vector<juce::RangedAudioParameter*> controllerTargets;
+    std::vector<std::atomic<float>*> controllerRawValues;
+    std::unique_ptr<std::atomic<float>[]> controllerValuesForHost;
+    //write the map into the state
+    void storeMidiLearn();
+
+    //two flat cascades make the Stereo Chain (lean realtime engine, runs on the dispatched kernels)
+    BiquadCascade leftChain, rightChain;
+
+    //cut filters of both channels as parallel sections
+    ParallelCutFilter lowCutParallel[2], highCutParallel[2];
+    bool useParallelCutFilters = false;
+
+    //optional: steps down to cheaper processing when the realtime path runs short of its budget
+    QualityGovernor governor;
+    //at the reduced update rate the parameters are only looked at every few blocks
+    static constexpr int reducedUpdateInterval = 4;
+    int blocksUntilUpdate = 0;
+    //at the reduced cut slopes the realtime chain's cut filters are designed with this slope at most
+    static constexpr Slope reducedCutSlope = Slope::Slope_24;
+    Slope cutSlopeLimit = Slope::Slope_48;
+    //publishes the governor's tier to the "Quality Tier" parameter on the message thread
+    void handleAsyncUpdate() override;
+
+    //optional: keeps the output as loud as the input
+    LoudnessCompensator loudnessCompensator;
+    bool autoGainActive = false;
+
+    //optional: the cut frequencies become crossover points, the bands go to the main, "Mid" and "High" outputs
+    Crossover crossovers[2];
+    //split the input into the three output buses
+    void processCrossover(juce::AudioBuffer<float>& buffer);
+
+    //dual mono and mid/side: both channels as two lanes of one pass, each lane with its own coefficients
+    std::unique_ptr<EQEngine> laneEngine;
+    //settings the lanes were last designed for
+    ChainSettings laneSettings[2];
+    //redesign the lanes whose parameter set changed
+    void updateLaneEngine(StereoMode stereoMode);
+
+    //high quality engine, used instead of the chains while the host renders offline (created the first time it is)
+    std::unique_ptr<OfflineEngine> offlineEngine;
+    //quality tier picked in prepareToPlay from isNonRealtime()
+    bool renderOffline = false;
+
+    //precomputed cut filter tables, shared by all instances
+    juce::SharedResourcePointer<CutFilterTables> cutFilterTables;
+    //the table of the prepared rate (nullptr while the mode is off), read on the audio thread without a lock
+    CutFilterTables::Table::Ptr activeTable;
+    //settings and sample rate the filters were last designed for
+    ChainSettings currentSettings;
+    double currentSampleRate = 0.0;
+
+    //update the crossover points
+    void updateCrossovers(const ChainSettings& chainSettings);
+    //update all the filters (audio thread: designed in place, no locks and no allocations)
     void updateFilters();
 
     //==============================================================================
@@ -0,0 +1,415 @@
+/*
+  ==============================================================================
+
+    PresetLibrary.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "PresetLibrary.h"
+#include "DspKernels.h"
+
+namespace
+{
+  //"EQPI"
+  constexpr int indexMagic = 0x49505145;
+  //2: file size and modification time of every preset instead of the folder's modification time
+  constexpr int indexVersion = 2;
+}
+
+PresetLibrary::PresetLibrary() : PresetLibrary(getDefaultDirectory())
+{
+}
+
+PresetLibrary::PresetLibrary(const juce::File& presetDirectory) : directory(presetDirectory)
+{
+}
+
+PresetLibrary::~PresetLibrary()
+{
+    //a running check finishes before the library goes away, its result is dropped
+    checker.reset();
+}
+
+juce::File PresetLibrary::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("3BandEQ")
+               .getChildFile("Presets");
+}
+
+juce::File PresetLibrary::getIndexFile() const
+{
+    //next to the folder, not inside it, so the folder only holds presets
+    return directory.getSiblingFile(directory.getFileName() + ".index");
+}
+
+//==============================================================================
+juce::Result PresetLibrary::loadIndex()
+{
+    if( ! directory.isDirectory() )
+    {
+        presets.clear();
+        return juce::Result::ok();
+    }
+
+    //a missing or broken index starts empty, every preset file is read then
+    if( ! indexRead )
+    {
+        if( ! readIndex() )
+            presets.clear();
+        indexRead = true;
+    }
+
+    return updateIndex();
+}
+
+juce::Result PresetLibrary::rebuildIndex()
+{
+    presets.clear();
+    indexRead = true;
+    ++modifications;
+
+    if( ! directory.isDirectory() )
+        return juce::Result::ok();
+
+    return updateIndex();
+}
+
+void PresetLibrary::checkFolder()
+{
+    if( ! indexRead )
+    {
+        if( ! readIndex() )
+            presets.clear();
+        indexRead = true;
+    }
+
+    //one check at a time, a request while one runs starts another one after it
+    if( checkRunning )
+    {
+        checkAgain = true;
+        return;
+    }
+
+    startCheck();
+}
+
+void PresetLibrary::startCheck()
+{
+    checkRunning = true;
+    checkAgain = false;
+
+    if( checker == nullptr )
+        checker = std::make_unique<juce::ThreadPool>(1);
+
+    //the check works on a copy, the presets stay untouched until its result is taken over on the message thread
+    const auto folder = directory;
+    const auto indexFile = getIndexFile();
+    const int startedAt = modifications;
+    auto indexed = std::make_shared<std::vector<PresetInfo>>(presets);
+    juce::WeakReference<PresetLibrary> library(this);
+
+    checker->addJob([folder, indexFile, startedAt, indexed, library]
+    {
+        bool changed = false;
+        auto updated = std::make_shared<std::vector<PresetInfo>>(scanFolder(folder, std::move(*indexed), changed));
+        if( changed )
+            writeIndex(indexFile, *updated);
+
+        juce::MessageManager::callAsync([library, startedAt, updated, changed]
+        {
+            auto* self = library.get();
+            if( self == nullptr )
+                return;
+
+            self->checkRunning = false;
+
+            //presets saved meanwhile aren't in the result, the folder is checked again with them
+            if( startedAt != self->modifications )
+            {
+                self->startCheck();
+                return;
+            }
+
+            if( changed )
+            {
+                self->presets = std::move(*updated);
+                ++self->modifications;
+                self->sendChangeMessage();
+            }
+
+            if( self->checkAgain )
+                self->startCheck();
+        });
+    });
+}
+
+juce::Result PresetLibrary::updateIndex()
+{
+    bool changed = false;
+    presets = scanFolder(directory, std::move(presets), changed);
+    ++modifications;
+
+    return changed ? writeIndex() : juce::Result::ok();
+}
+
+std::vector<PresetInfo> PresetLibrary::scanFolder(const juce::File& directory, std::vector<PresetInfo> indexed, bool& changed)
+{
+    //presets edited in place keep the folder's modification time, so every file is compared on its own,
+    //by the size and time the directory listing already has (the files are only opened when they changed)
+    juce::HashMap<juce::String, int> entries;
+    for( int i = 0; i < int(indexed.size()); ++i )
+        entries.set(indexed[size_t(i)].fileName, i);
+
+    std::vector<PresetInfo> updated;
+    updated.reserve(indexed.size());
+    changed = false;
+
+    for( const auto& entry : juce::RangedDirectoryIterator(directory, false, juce::String("*") + fileExtension,
+                                                           juce::File::findFiles) )
+    {
+        //the name is made once per file and looked up in the hash map, not compared with every indexed preset
+        const auto fileName = entry.getFile().getFileName();
+        const auto fileSize = entry.getFileSize();
+        const auto fileTime = entry.getModificationTime();
+
+        if( entries.contains(fileName) )
+        {
+            auto& preset = indexed[size_t(entries[fileName])];
+            if( preset.fileSize == fileSize && preset.fileTime == fileTime )
+            {
+                updated.push_back(std::move(preset));
+                continue;
+            }
+        }
+
+        changed = true;
+
+        juce::MemoryBlock data;
+        if( ! entry.getFile().loadFileAsData(data) )
+            continue;
+
+        auto state = juce::ValueTree::readFromData(data.getData(), data.getSize());
+        if( ! state.isValid() )
+            continue;
+
+        PresetInfo info;
+        info.name = state.getProperty("PresetName", entry.getFile().getFileNameWithoutExtension());
+        info.tags = state.getProperty("PresetTags");
+        info.fileName = fileName;
+        info.fileSize = fileSize;
+        info.fileTime = fileTime;
+        info.settings = getChainSettings(state);
+        info.curve = computeCurve(info.settings);
+        updated.push_back(std::move(info));
+    }
+
+    //presets whose files are gone
+    changed = changed || updated.size() != indexed.size();
+
+    std::sort(updated.begin(), updated.end(), [](const PresetInfo& a, const PresetInfo& b)
+    {
+        return a.name.compareNatural(b.name) < 0;
+    });
+
+    return updated;
+}
+
+juce::Result PresetLibrary::writeIndex() const
+{
+    return writeIndex(getIndexFile(), presets);
+}
+
+juce::Result PresetLibrary::writeIndex(const juce::File& indexFile, const std::vector<PresetInfo>& indexedPresets)
+{
+    juce::MemoryOutputStream out;
+    out.writeInt(indexMagic);
+    out.writeInt(indexVersion);
+    out.writeInt(int(indexedPresets.size()));
+
+    for( const auto& preset : indexedPresets )
+    {
+        out.writeString(preset.name);
+        out.writeString(preset.tags);
+        out.writeString(preset.fileName);
+        out.writeInt64(preset.fileSize);
+        out.writeInt64(preset.fileTime.toMilliseconds());
+        out.writeFloat(preset.settings.lowCutFreq);
+        out.writeFloat(preset.settings.highCutFreq);
+        out.writeFloat(preset.settings.peakFreq);
+        out.writeFloat(preset.settings.peakGainInDecibels);
+        out.writeFloat(preset.settings.peakQuality);
+        out.writeByte(char(preset.settings.lowCutSlope));
+        out.writeByte(char(preset.settings.highCutSlope));
+        out.write(preset.curve.data(), preset.curve.size());
+    }
+
+    if( ! indexFile.replaceWithData(out.getData(), out.getDataSize()) )
+        return juce::Result::fail("Can't write " + indexFile.getFullPathName());
+
+    return juce::Result::ok();
+}
+
+bool PresetLibrary::readIndex()
+{
+    //one read for the whole index, everything after that is parsed from memory
+    juce::MemoryBlock data;
+    if( ! getIndexFile().loadFileAsData(data) )
+        return false;
+
+    juce::MemoryInputStream in(data, false);
+    if( in.readInt() != indexMagic || in.readInt() != indexVersion )
+        return false;
+
+    const int count = in.readInt();
+    if( count < 0 )
+        return false;
+
+    std::vector<PresetInfo> loaded(size_t(count));
+    for( auto& preset : loaded )
+    {
+        preset.name = in.readString();
+        preset.tags = in.readString();
+        preset.fileName = in.readString();
+        preset.fileSize = in.readInt64();
+        preset.fileTime = juce::Time(in.readInt64());
+        preset.settings.lowCutFreq = in.readFloat();
+        preset.settings.highCutFreq = in.readFloat();
+        preset.settings.peakFreq = in.readFloat();
+        preset.settings.peakGainInDecibels = in.readFloat();
+        preset.settings.peakQuality = in.readFloat();
+        preset.settings.lowCutSlope = static_cast<Slope>(juce::jlimit(0, 3, int(in.readByte())));
+        preset.settings.highCutSlope = static_cast<Slope>(juce::jlimit(0, 3, int(in.readByte())));
+
+        //a truncated index is rebuilt
+        if( in.read(preset.curve.data(), int(preset.curve.size())) != int(preset.curve.size()) )
+            return false;
+    }
+
+    presets = std::move(loaded);
+    return true;
+}
+
+//==============================================================================
+juce::ValueTree PresetLibrary::loadState(int index) const
+{
+    juce::MemoryBlock data;
+    if( ! directory.getChildFile(getPreset(index).fileName).loadFileAsData(data) )
+        return {};
+
+    return juce::ValueTree::readFromData(data.getData(), data.getSize());
+}
+
+juce::Result PresetLibrary::savePreset(const juce::String& name, const juce::String& tags, const juce::ValueTree& state)
+{
+    //the index is rewritten as a whole, so what it had has to be there first
+    //(files that aren't indexed yet are added by the next check of the folder)
+    if( ! indexRead )
+    {
+        if( ! readIndex() )
+            presets.clear();
+        indexRead = true;
+    }
+
+    if( ! directory.createDirectory() )
+        return juce::Result::fail("Can't create " + directory.getFullPathName());
+
+    auto presetState = state.createCopy();
+    presetState.setProperty("PresetName", name, nullptr);
+    presetState.setProperty("PresetTags", tags, nullptr);
+
+    const auto file = directory.getChildFile(juce::File::createLegalFileName(name) + fileExtension);
+    juce::MemoryOutputStream out;
+    presetState.writeToStream(out);
+    if( ! file.replaceWithData(out.getData(), out.getDataSize()) )
+        return juce::Result::fail("Can't write " + file.getFullPathName());
+
+    PresetInfo info;
+    info.name = name;
+    info.tags = tags;
+    info.fileName = file.getFileName();
+    info.fileSize = file.getSize();
+    info.fileTime = file.getLastModificationTime();
+    info.settings = getChainSettings(state);
+    info.curve = computeCurve(info.settings);
+
+    //replace a preset with the same file, otherwise insert in name order
+    auto existing = std::find_if(presets.begin(), presets.end(), [&info](const PresetInfo& preset)
+    {
+        return preset.fileName == info.fileName;
+    });
+    if( existing != presets.end() )
+        presets.erase(existing);
+
+    auto position = std::lower_bound(presets.begin(), presets.end(), info, [](const PresetInfo& a, const PresetInfo& b)
+    {
+        return a.name.compareNatural(b.name) < 0;
+    });
+    presets.insert(position, std::move(info));
+    ++modifications;
+
+    return writeIndex();
+}
+
+//==============================================================================
+std::array<juce::int8, PresetInfo::numCurvePoints> PresetLibrary::computeCurve(const ChainSettings& chainSettings)
+{
+    //thumbnails show the response at 48 kHz
+    constexpr double sampleRate = 48000.0;
+    constexpr int numPoints = PresetInfo::numCurvePoints;
+
+    std::array<double, numPoints> cosW, cos2W, mags;
+    for( int i = 0; i < numPoints; ++i )
+    {
+        const double freq = juce::mapToLog10(double(i) / double(numPoints - 1), 20.0, 20000.0);
+        const double omega = juce::MathConstants<double>::twoPi * freq / sampleRate;
+        cosW[size_t(i)] = std::cos(omega);
+        cos2W[size_t(i)] = std::cos(2.0 * omega);
+        mags[size_t(i)] = 1.0;
+    }
+
+    auto& kernels = DspKernels::get();
+    auto apply = [&](const juce::dsp::IIR::Coefficients<float>& coefficients)
+    {
+        auto* c = coefficients.getRawCoefficients();
+        kernels.multiplySquaredMagnitudes({ c[0], c[1], c[2], c[3], c[4] }, cosW.data(), cos2W.data(), mags.data(), numPoints);
+    };
+
+    for( auto* coefficients : makeLowCutFilter(chainSettings, sampleRate) )
+        apply(*coefficients);
+    apply(*makePeakFilter(chainSettings, sampleRate));
+    for( auto* coefficients : makeHighCutFilter(chainSettings, sampleRate) )
+        apply(*coefficients);
+
+    std::array<juce::int8, numPoints> curve;
+    for( int i = 0; i < numPoints; ++i )
+    {
+        const double decibels = 10.0 * std::log10(mags[size_t(i)] + 1.0e-30);
+        curve[size_t(i)] = juce::int8(juce::jlimit(-128, 127, juce::roundToInt(decibels * 4.0)));
+    }
+
+    return curve;
+}
+
+ChainSettings PresetLibrary::getChainSettings(const juce::ValueTree& state)
+{
+    //parameters are stored by the AudioProcessorValueTreeState as PARAM children with an id and a value
+    auto get = [&state](const char* parameterID, float defaultValue)
+    {
+        auto parameter = state.getChildWithProperty("id", parameterID);
+        return parameter.isValid() ? float(parameter.getProperty("value", defaultValue)) : defaultValue;
+    };
+
+    ChainSettings settings;
+    settings.lowCutFreq = get("LowCut Freq", 20.f);
+    settings.highCutFreq = get("HighCut Freq", 20000.f);
+    settings.peakFreq = get("Peak Freq", 750.f);
+    settings.peakGainInDecibels = get("Peak Gain", 0.f);
+    settings.peakQuality = get("Peak Quality", 1.f);
+    settings.lowCutSlope = static_cast<Slope>(juce::jlimit(0, 3, int(get("LowCut Slope", 0.f))));
+    settings.highCutSlope = static_cast<Slope>(juce::jlimit(0, 3, int(get("HighCut Slope", 0.f))));
+
+    return settings;
+}
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    PresetLibrary.h
+    Created: 18 Oct 2026
+
+    Presets on disk, one file per preset with the full plugin state, plus a
+    compact binary index next to the preset folder. The index holds what a
+    browser needs for every preset (name, tags, the chain settings and a
+    low resolution response curve), so browsing only ever reads the index
+    and a preset's full state is read when it's actually loaded.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+
+struct PresetInfo
+{
+  //points of the thumbnail curve, log spaced from 20 Hz to 20 kHz
+  static constexpr int numCurvePoints = 64;
+
+  juce::String name, tags;
+  //preset file inside the library folder, with its size and modification time when it was indexed
+  juce::String fileName;
+  juce::int64 fileSize = 0;
+  juce::Time fileTime;
+  ChainSettings settings;
+  //response of the chain in quarter dB (-32 to +31.75 dB)
+  std::array<juce::int8, numCurvePoints> curve{};
+
+  //curve point in dB
+  float getCurveDecibels(int index) const { return curve[size_t(index)] * 0.25f; }
+};
+
+//use it through juce::SharedResourcePointer<PresetLibrary>, so all editors share the index
+//(everything but the background check of the folder happens on the message thread)
+class PresetLibrary : public juce::ChangeBroadcaster
+{
+public:
+  PresetLibrary();
+  explicit PresetLibrary(const juce::File& directory);
+  ~PresetLibrary() override;
+
+  //<user application data>/3BandEQ/Presets
+  static juce::File getDefaultDirectory();
+
+  //read the index (once) and bring it up to date with the folder: only the preset files that were added
+  //or changed (size or modification time) since they were indexed are read, removed ones are dropped
+  juce::Result loadIndex();
+  //same without waiting for the folder: the index is read (once) right away, the folder is compared with it
+  //on a background thread, a change message is sent when that changed the presets
+  void checkFolder();
+  //read all preset files again (slow, only needed if the index is suspected to be wrong)
+  juce::Result rebuildIndex();
+
+  int getNumPresets() const { return int(presets.size()); }
+  const PresetInfo& getPreset(int index) const { return presets[size_t(index)]; }
+
+  //full state of a preset, read from its file
+  juce::ValueTree loadState(int index) const;
+
+  //write a preset file and add it to the index (a preset with the same name is replaced)
+  juce::Result savePreset(const juce::String& name, const juce::String& tags, const juce::ValueTree& state);
+
+  //thumbnail curve of chain settings
+  static std::array<juce::int8, PresetInfo::numCurvePoints> computeCurve(const ChainSettings& chainSettings);
+  //chain settings stored in a plugin state
+  static ChainSettings getChainSettings(const juce::ValueTree& state);
+
+private:
+  juce::File directory;
+  std::vector<PresetInfo> presets;
+  //the index file was read (or found missing or broken), afterwards presets is only compared with the folder
+  bool indexRead = false;
+
+  //background check of the folder, created with the first one
+  std::unique_ptr<juce::ThreadPool> checker;
+  bool checkRunning = false, checkAgain = false;
+  //counts changes of presets on the message thread, a check that started before one is discarded
+  int modifications = 0;
+
+  juce::File getIndexFile() const;
+  juce::Result writeIndex() const;
+  static juce::Result writeIndex(const juce::File& indexFile, const std::vector<PresetInfo>& indexedPresets);
+  bool readIndex();
+  //compare the presets with the files in the folder and read the files that aren't indexed as they are,
+  //the index is written if anything changed
+  juce::Result updateIndex();
+  //presets as the folder has them now (sorted by name), from the indexed ones: entries of unchanged files are kept,
+  //new or changed files are read, removed ones are dropped (no members, safe on any thread)
+  static std::vector<PresetInfo> scanFolder(const juce::File& directory, std::vector<PresetInfo> indexed, bool& changed);
+  void startCheck();
+
+  static constexpr const char* fileExtension = ".eqpreset";
+
+  JUCE_DECLARE_WEAK_REFERENCEABLE (PresetLibrary)
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PresetLibrary)
+};
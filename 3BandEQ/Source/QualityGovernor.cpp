@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    QualityGovernor.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "QualityGovernor.h"
+
+juce::String QualityGovernor::getTierName(int tier)
+{
+    switch( tier )
+    {
+        case Full: return "full";
+        case ReducedUpdateRate: return "reduced update rate";
+        case NeutralStageElision: return "neutral peak skipped";
+        case ReducedCutSlopes: return "cut slopes reduced";
+        default: return {};
+    }
+}
+
+void QualityGovernor::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    tier = Full;
+    load = pressureSeconds = headroomSeconds = 0.0;
+}
+
+void QualityGovernor::setEnabled(bool shouldBeEnabled)
+{
+    if( enabled == shouldBeEnabled )
+        return;
+
+    enabled = shouldBeEnabled;
+    tier = Full;
+    load = pressureSeconds = headroomSeconds = 0.0;
+}
+
+void QualityGovernor::blockStarted()
+{
+    if( enabled )
+        startTicks = juce::Time::getHighResolutionTicks();
+}
+
+bool QualityGovernor::blockFinished(int numSamples)
+{
+    if( ! enabled || numSamples <= 0 )
+        return false;
+
+    const double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    const double budget = numSamples / sampleRate;
+
+    //smoothed over about 50 ms of audio, whatever the block size
+    const double smoothing = 1.0 - std::exp(-budget / 0.05);
+    load += smoothing * (elapsed / budget - load);
+
+    //pressure and headroom only count while they last, a single spike doesn't change anything
+    pressureSeconds = load > pressureLoad ? pressureSeconds + budget : 0.0;
+    headroomSeconds = load < headroomLoad ? headroomSeconds + budget : 0.0;
+
+    const auto current = tier.load();
+    if( pressureSeconds > stepDownTime && current + 1 < numTiers )
+    {
+        tier = static_cast<Tier>(current + 1);
+        pressureSeconds = 0.0;
+        return true;
+    }
+    if( headroomSeconds > stepUpTime && current > Full )
+    {
+        tier = static_cast<Tier>(current - 1);
+        headroomSeconds = 0.0;
+        return true;
+    }
+
+    return false;
+}
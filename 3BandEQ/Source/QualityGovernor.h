@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    QualityGovernor.h
+    Created: 18 Oct 2026
+
+    Measures what processBlock costs relative to the real-time budget of the
+    block. Under sustained pressure it steps down to cheaper processing
+    tiers, and it steps back up (with hysteresis) once there is headroom
+    again.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class QualityGovernor
+{
+public:
+  //from best to cheapest, every tier includes the savings of the ones before it
+  enum Tier
+  {
+    Full,
+    //parameters are only looked at every few blocks
+    ReducedUpdateRate,
+    //the peak filter is skipped while it's at 0 dB and has rung out (the output doesn't change)
+    NeutralStageElision,
+    //the cut filters run at 24 dB/Oct at most, up to 4 of the 9 stages less (the output does change)
+    ReducedCutSlopes,
+    numTiers
+  };
+
+  static juce::String getTierName(int tier);
+
+  //share of the block's real-time budget above which the governor counts the block as under pressure,
+  //and below which it counts as headroom.
+  //the whole chain (9 stages, stereo) takes about 20 ns per sample frame with the fused kernels ("EQTool kernels"),
+  //0.1% of the 20.8 us a frame has at 48 kHz, so the load only gets near a quarter when the thread is starved
+  //or the CPU is throttled, and then this instance alone already eats a quarter of a budget the host shares
+  //between all plugins of the graph. the gap to headroomLoad keeps the tier from flipping back and forth
+  static constexpr double pressureLoad = 0.25, headroomLoad = 0.1;
+  //how long the pressure or the headroom has to last (in seconds of audio) before the tier changes
+  static constexpr double stepDownTime = 0.1, stepUpTime = 2.0;
+
+  void prepare(double sampleRate);
+
+  //while disabled the tier stays at Full and nothing is measured
+  void setEnabled(bool shouldBeEnabled);
+  bool isEnabled() const { return enabled; }
+
+  //call around the work of one block (audio thread only)
+  void blockStarted();
+  //returns true if the tier changed
+  bool blockFinished(int numSamples);
+
+  Tier getTier() const { return tier.load(); }
+  //smoothed share of the real-time budget used by the last blocks
+  double getLoad() const { return load; }
+
+private:
+  double sampleRate = 44100.0;
+  bool enabled = false;
+  std::atomic<Tier> tier{Full};
+
+  juce::int64 startTicks = 0;
+  double load = 0.0, pressureSeconds = 0.0, headroomSeconds = 0.0;
+};
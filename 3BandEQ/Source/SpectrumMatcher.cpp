@@ -0,0 +1,416 @@
+/*
+  ==============================================================================
+
+    SpectrumMatcher.cpp
+    Created: 18 Oct 2026
+
+  ==============================================================================
+*/
+
+#include "SpectrumMatcher.h"
+#include "DspKernels.h"
+#include "EQEngine.h"
+
+double AverageSpectrum::getFrequency(int index)
+{
+    return minFrequency * std::pow(maxFrequency / minFrequency, double(index) / double(numPoints - 1));
+}
+
+//==============================================================================
+namespace
+{
+  constexpr int fftSize = 1 << SpectrumMatcher::fftOrder;
+  constexpr int hop = fftSize / 2;
+  constexpr int numBins = fftSize / 2 + 1;
+
+  //accumulate the power spectra of the frames [firstFrame, endFrame), all channels summed,
+  //returns false if shouldStop asked to stop before all frames were done
+  bool analyzeFrames(juce::AudioFormatReader& reader, juce::int64 firstFrame, juce::int64 endFrame, std::vector<double>& power,
+                     const std::function<bool()>& shouldStop)
+  {
+      //frames are read in blocks, so every read covers many frames at once
+      constexpr int framesPerBlock = 64;
+
+      juce::dsp::FFT fft(SpectrumMatcher::fftOrder);
+      juce::dsp::WindowingFunction<float> window(size_t(fftSize), juce::dsp::WindowingFunction<float>::hann, false);
+      const int numChannels = int(reader.numChannels);
+      juce::AudioBuffer<float> block(numChannels, (framesPerBlock - 1) * hop + fftSize);
+      std::vector<float> fftData(size_t(2 * fftSize));
+
+      for( auto frame = firstFrame; frame < endFrame; frame += framesPerBlock )
+      {
+          if( shouldStop != nullptr && shouldStop() )
+              return false;
+
+          const int numFrames = int(juce::jmin(juce::int64(framesPerBlock), endFrame - frame));
+          //reads past the end of the file are filled with zeros
+          reader.read(&block, 0, (numFrames - 1) * hop + fftSize, frame * hop, true, true);
+
+          for( int f = 0; f < numFrames; ++f )
+          {
+              for( int ch = 0; ch < numChannels; ++ch )
+              {
+                  std::fill(fftData.begin(), fftData.end(), 0.f);
+                  std::copy_n(block.getReadPointer(ch, f * hop), fftSize, fftData.begin());
+                  window.multiplyWithWindowingTable(fftData.data(), size_t(fftSize));
+                  fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+                  for( int bin = 0; bin < numBins; ++bin )
+                      power[size_t(bin)] += double(fftData[size_t(bin)]) * double(fftData[size_t(bin)]);
+              }
+          }
+      }
+
+      return true;
+  }
+}
+
+juce::Result SpectrumMatcher::analyzeFile(const juce::File& file, juce::ThreadPool& pool, AverageSpectrum& result,
+                                          std::function<bool()> shouldStop)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    //memory mapped readers read straight from the mapping and keep no stream position,
+    //so all jobs can share one, other formats get a reader (and stream) per job
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(juce::WavAudioFormat().createMemoryMappedReader(file));
+    if( mapped == nullptr )
+        mapped.reset(juce::AiffAudioFormat().createMemoryMappedReader(file));
+    if( mapped != nullptr && ! mapped->mapEntireFile() )
+        mapped.reset();
+
+    std::unique_ptr<juce::AudioFormatReader> probe;
+    juce::AudioFormatReader* info = mapped.get();
+    if( info == nullptr )
+    {
+        probe.reset(formatManager.createReaderFor(file));
+        info = probe.get();
+    }
+    if( info == nullptr || info->numChannels == 0 )
+        return juce::Result::fail("Can't read " + file.getFullPathName());
+
+    const double sampleRate = info->sampleRate;
+    const int numChannels = int(info->numChannels);
+    //files shorter than one frame are analyzed as one zero padded frame
+    const juce::int64 numFrames = juce::jmax(juce::int64(1), (info->lengthInSamples - fftSize) / hop + 1);
+    probe.reset();
+
+    //a few jobs per thread, so threads that finish early pick up the rest
+    const int numJobs = int(juce::jmin(numFrames, juce::int64(4 * juce::jmax(1, pool.getNumThreads()))));
+    const juce::int64 framesPerJob = (numFrames + numJobs - 1) / numJobs;
+
+    std::vector<std::vector<double>> jobPower(size_t(numJobs), std::vector<double>(size_t(numBins), 0.0));
+    std::atomic<int> remaining{numJobs};
+    std::atomic<bool> failed{false}, stopped{false};
+    juce::WaitableEvent finished;
+
+    for( int job = 0; job < numJobs; ++job )
+    {
+        pool.addJob([&, job]
+        {
+            std::unique_ptr<juce::AudioFormatReader> ownReader;
+            juce::AudioFormatReader* reader = mapped.get();
+            if( reader == nullptr )
+            {
+                ownReader.reset(formatManager.createReaderFor(file));
+                reader = ownReader.get();
+            }
+
+            const auto first = job * framesPerJob;
+            const auto end = juce::jmin(numFrames, first + framesPerJob);
+
+            if( reader == nullptr )
+                failed = true;
+            else if( end > first && ! analyzeFrames(*reader, first, end, jobPower[size_t(job)], shouldStop) )
+                stopped = true;
+
+            if( --remaining == 0 )
+                finished.signal();
+        });
+    }
+
+    finished.wait();
+
+    if( stopped )
+        return juce::Result::fail("Analysis of " + file.getFullPathName() + " was stopped");
+    if( failed )
+        return juce::Result::fail("Can't read " + file.getFullPathName());
+
+    std::vector<double> power(size_t(numBins), 0.0);
+    for( auto& partial : jobPower )
+        for( int bin = 0; bin < numBins; ++bin )
+            power[size_t(bin)] += partial[size_t(bin)] / double(numFrames * numChannels);
+
+    //average the bins within 1/6 octave around every grid point, at the bottom a grid point may fall between bins
+    const double binWidth = sampleRate / fftSize;
+    for( int i = 0; i < AverageSpectrum::numPoints; ++i )
+    {
+        const double freq = AverageSpectrum::getFrequency(i);
+        if( freq >= 0.5 * sampleRate )
+        {
+            result.decibels[size_t(i)] = AverageSpectrum::silenceDecibels;
+            continue;
+        }
+
+        int first = juce::jmax(1, int(std::ceil(freq * std::pow(2.0, -1.0 / 12.0) / binWidth)));
+        int last = juce::jmin(numBins - 1, int(std::floor(freq * std::pow(2.0, 1.0 / 12.0) / binWidth)));
+        if( last < first )
+            first = last = juce::jlimit(1, numBins - 1, juce::roundToInt(freq / binWidth));
+
+        double sum = 0.0;
+        for( int bin = first; bin <= last; ++bin )
+            sum += power[size_t(bin)];
+
+        const double average = sum / double(last - first + 1);
+        result.decibels[size_t(i)] = average > 0.0 ? juce::jmax(AverageSpectrum::silenceDecibels, 10.0 * std::log10(average))
+                                                   : AverageSpectrum::silenceDecibels;
+    }
+
+    result.sampleRate = sampleRate;
+    result.numFrames = numFrames;
+    return juce::Result::ok();
+}
+
+//==============================================================================
+namespace
+{
+  //the fitted parameters, normalised to 0..1 so the optimizer moves all of them on a similar scale
+  enum Parameter
+  {
+    LowCutFreq,
+    HighCutFreq,
+    PeakFreq,
+    PeakGain,
+    PeakQuality,
+    numParameters
+  };
+  using Point = std::array<double, numParameters>;
+
+  //how far below the average the curves are followed, deeper differences only have to be "very low"
+  constexpr double floorDecibels = -60.0;
+
+  //squared error of the chain response against the target difference curve,
+  //the grid's cos(w) and cos(2w) are computed once and every biquad runs through the magnitude kernel
+  struct Evaluator
+  {
+    double sampleRate = 0.0, maxFrequency = 0.0;
+    std::vector<double> cosW, cos2W, target, mags;
+    Slope lowCutSlope{Slope::Slope_12}, highCutSlope{Slope::Slope_12};
+
+    ChainSettings toSettings(const Point& point) const
+    {
+      auto logMap = [](double value, double low, double high)
+      {
+        return low * std::pow(high / low, juce::jlimit(0.0, 1.0, value));
+      };
+
+      ChainSettings settings;
+      settings.lowCutFreq = float(logMap(point[LowCutFreq], AverageSpectrum::minFrequency, maxFrequency));
+      settings.highCutFreq = float(logMap(point[HighCutFreq], AverageSpectrum::minFrequency, maxFrequency));
+      settings.peakFreq = float(logMap(point[PeakFreq], AverageSpectrum::minFrequency, maxFrequency));
+      settings.peakGainInDecibels = float(juce::jmap(juce::jlimit(0.0, 1.0, point[PeakGain]), -24.0, 24.0));
+      settings.peakQuality = float(logMap(point[PeakQuality], 0.1, 10.0));
+      settings.lowCutSlope = lowCutSlope;
+      settings.highCutSlope = highCutSlope;
+      return settings;
+    }
+
+    //returns the mean squared error, offset receives the level difference that is left out of it
+    double evaluate(const Point& point, double* offset = nullptr)
+    {
+      const auto settings = toSettings(point);
+      const int num = int(target.size());
+      std::fill(mags.begin(), mags.end(), 1.0);
+
+      //designed on the stack, this runs a few hundred times per match
+      DspKernels::Biquad stages[EQEngine::maxStages];
+      const int numStages = EQEngine::design(settings, sampleRate, stages);
+
+      auto& kernels = DspKernels::get();
+      for( int n = 0; n < numStages; ++n )
+        kernels.multiplySquaredMagnitudes(stages[n], cosW.data(), cos2W.data(), mags.data(), num);
+
+      //the chain has no output gain, so the broadband level difference is taken out before comparing the shapes
+      double mean = 0.0;
+      for( int i = 0; i < num; ++i )
+      {
+        mags[size_t(i)] = target[size_t(i)] - juce::jmax(floorDecibels, 10.0 * std::log10(mags[size_t(i)] + 1.0e-30));
+        mean += mags[size_t(i)];
+      }
+      mean /= num;
+
+      double error = 0.0;
+      for( int i = 0; i < num; ++i )
+        error += juce::square(mags[size_t(i)] - mean);
+
+      if( offset != nullptr )
+        *offset = mean;
+      return error / num;
+    }
+  };
+
+  //Nelder-Mead simplex search, needs no gradients and only a few hundred evaluations for five parameters
+  Point minimize(Evaluator& evaluator, const Point& start, double step, int maxIterations)
+  {
+    std::array<Point, numParameters + 1> simplex;
+    std::array<double, numParameters + 1> values;
+
+    for( size_t i = 0; i < simplex.size(); ++i )
+    {
+      simplex[i] = start;
+      if( i > 0 )
+        simplex[i][i - 1] += step;
+      values[i] = evaluator.evaluate(simplex[i]);
+    }
+
+    auto combine = [](const Point& a, const Point& b, double t)
+    {
+      Point result;
+      for( size_t i = 0; i < result.size(); ++i )
+        result[i] = a[i] + t * (b[i] - a[i]);
+      return result;
+    };
+
+    for( int iteration = 0; iteration < maxIterations; ++iteration )
+    {
+      //order best to worst
+      std::array<size_t, numParameters + 1> order;
+      std::iota(order.begin(), order.end(), size_t(0));
+      std::sort(order.begin(), order.end(), [&values](size_t a, size_t b) { return values[a] < values[b]; });
+
+      const auto best = order.front(), worst = order.back(), secondWorst = order[order.size() - 2];
+      if( values[worst] - values[best] < 1.0e-6 )
+        break;
+
+      Point centroid{};
+      for( size_t i = 0; i < simplex.size(); ++i )
+        if( i != worst )
+          for( size_t p = 0; p < centroid.size(); ++p )
+            centroid[p] += simplex[i][p] / double(numParameters);
+
+      const auto reflected = combine(centroid, simplex[worst], -1.0);
+      const double reflectedValue = evaluator.evaluate(reflected);
+
+      if( reflectedValue < values[best] )
+      {
+        const auto expanded = combine(centroid, simplex[worst], -2.0);
+        const double expandedValue = evaluator.evaluate(expanded);
+        if( expandedValue < reflectedValue )
+        {
+          simplex[worst] = expanded;
+          values[worst] = expandedValue;
+        }
+        else
+        {
+          simplex[worst] = reflected;
+          values[worst] = reflectedValue;
+        }
+        continue;
+      }
+
+      if( reflectedValue < values[secondWorst] )
+      {
+        simplex[worst] = reflected;
+        values[worst] = reflectedValue;
+        continue;
+      }
+
+      const auto contracted = combine(centroid, simplex[worst], 0.5);
+      const double contractedValue = evaluator.evaluate(contracted);
+      if( contractedValue < values[worst] )
+      {
+        simplex[worst] = contracted;
+        values[worst] = contractedValue;
+        continue;
+      }
+
+      //shrink towards the best point
+      for( size_t i = 0; i < simplex.size(); ++i )
+      {
+        if( i == best )
+          continue;
+        simplex[i] = combine(simplex[best], simplex[i], 0.5);
+        values[i] = evaluator.evaluate(simplex[i]);
+      }
+    }
+
+    const auto best = size_t(std::min_element(values.begin(), values.end()) - values.begin());
+    return simplex[best];
+  }
+}
+
+SpectrumMatcher::Match SpectrumMatcher::fit(const AverageSpectrum& source, const AverageSpectrum& reference, double sampleRate)
+{
+    Evaluator evaluator;
+    evaluator.sampleRate = sampleRate;
+    //stay clear of Nyquist for every rate involved
+    const double nyquistLimit = 0.45 * juce::jmin(sampleRate, source.sampleRate, reference.sampleRate);
+    evaluator.maxFrequency = juce::jmin(AverageSpectrum::maxFrequency, nyquistLimit);
+
+    //only grid points where both files have content take part
+    for( int i = 0; i < AverageSpectrum::numPoints; ++i )
+    {
+        const double freq = AverageSpectrum::getFrequency(i);
+        const double src = source.decibels[size_t(i)], ref = reference.decibels[size_t(i)];
+        if( freq >= nyquistLimit || src <= AverageSpectrum::silenceDecibels || ref <= AverageSpectrum::silenceDecibels )
+            continue;
+
+        const double omega = juce::MathConstants<double>::twoPi * freq / sampleRate;
+        evaluator.cosW.push_back(std::cos(omega));
+        evaluator.cos2W.push_back(std::cos(2.0 * omega));
+        evaluator.target.push_back(ref - src);
+    }
+
+    Match match;
+    match.settings = evaluator.toSettings({ 0.0, 1.0, 0.5, 0.5, 0.5 });
+    if( evaluator.target.empty() )
+        return match;
+
+    evaluator.mags.resize(evaluator.target.size());
+
+    //deep differences (a reference that is cut where the source isn't) count as "at the floor"
+    auto sorted = evaluator.target;
+    std::nth_element(sorted.begin(), sorted.begin() + long(sorted.size() / 2), sorted.end());
+    const double median = sorted[sorted.size() / 2];
+    for( auto& difference : evaluator.target )
+        difference = juce::jmax(difference, median + floorDecibels);
+
+    //start with open cuts and the peak where the difference deviates most from the median
+    size_t peakIndex = 0;
+    for( size_t i = 1; i < evaluator.target.size(); ++i )
+        if( std::abs(evaluator.target[i] - median) > std::abs(evaluator.target[peakIndex] - median) )
+            peakIndex = i;
+
+    const double peakFreq = std::acos(evaluator.cosW[peakIndex]) * sampleRate / juce::MathConstants<double>::twoPi;
+    Point start{ 0.0, 1.0,
+                 std::log(peakFreq / AverageSpectrum::minFrequency) / std::log(evaluator.maxFrequency / AverageSpectrum::minFrequency),
+                 juce::jmap(juce::jlimit(-24.0, 24.0, evaluator.target[peakIndex] - median), -24.0, 24.0, 0.0, 1.0),
+                 0.5 };
+
+    //the slopes are discrete, every combination gets its own search
+    double bestError = std::numeric_limits<double>::max();
+    for( int lowCutSlope = Slope_12; lowCutSlope <= Slope_48; ++lowCutSlope )
+    {
+        for( int highCutSlope = Slope_12; highCutSlope <= Slope_48; ++highCutSlope )
+        {
+            evaluator.lowCutSlope = static_cast<Slope>(lowCutSlope);
+            evaluator.highCutSlope = static_cast<Slope>(highCutSlope);
+
+            auto point = minimize(evaluator, start, 0.15, 400);
+            //restart from the result, the simplex may have collapsed early
+            point = minimize(evaluator, point, 0.05, 200);
+
+            double offset = 0.0;
+            const double error = evaluator.evaluate(point, &offset);
+            if( error < bestError )
+            {
+                bestError = error;
+                match.settings = evaluator.toSettings(point);
+                match.levelOffsetInDecibels = offset;
+            }
+        }
+    }
+
+    match.remainingErrorInDecibels = std::sqrt(bestError);
+    return match;
+}
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    SpectrumMatcher.h
+    Created: 18 Oct 2026
+
+    Reference matching: the long-term average spectra of a source and a
+    reference file are measured, and ChainSettings are fitted so the chain
+    turns the spectrum of the source into the one of the reference.
+    Files are read memory-mapped where the format allows it and the FFT
+    frames are analyzed in parallel on a thread pool.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "FilterChain.h"
+
+//long-term average spectrum of a file on a log frequency grid
+struct AverageSpectrum
+{
+  static constexpr int numPoints = 128;
+  static constexpr double minFrequency = 20.0, maxFrequency = 20000.0;
+  //frequency of a grid point
+  static double getFrequency(int index);
+
+  //average power in dB at every grid point, grid points at or above Nyquist get silenceDecibels
+  static constexpr double silenceDecibels = -200.0;
+  std::array<double, numPoints> decibels;
+
+  double sampleRate = 0.0;
+  juce::int64 numFrames = 0;
+};
+
+namespace SpectrumMatcher
+{
+  //frames of 4096 samples (about 85 ms at 48 kHz), half overlapping
+  constexpr int fftOrder = 12;
+
+  //measure the average spectrum of a whole file, the frames are spread over the pool.
+  //shouldStop is polled between blocks of frames, the analysis fails when it returns true
+  juce::Result analyzeFile(const juce::File& file, juce::ThreadPool& pool, AverageSpectrum& result,
+                           std::function<bool()> shouldStop = nullptr);
+
+  struct Match
+  {
+    ChainSettings settings;
+    //broadband level difference the chain can't account for (reference minus processed source)
+    double levelOffsetInDecibels = 0.0;
+    //rms difference between the matched and the reference spectrum
+    double remainingErrorInDecibels = 0.0;
+  };
+
+  //fit the chain settings to the difference of the two spectra, the filters are designed for sampleRate
+  Match fit(const AverageSpectrum& source, const AverageSpectrum& reference, double sampleRate);
+}